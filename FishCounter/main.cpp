@@ -12,14 +12,30 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <regex>
 #include <io.h>
 #include <fcntl.h>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <fstream>
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
+#include "../StreamCounter1/src/byte_tracker.hpp"
+#include "../StreamCounter1/src/flow_propagator.hpp"
+#include "../StreamCounter1/src/inference_backend.hpp"
+#include "../StreamCounter1/src/inference_cadence.hpp"
+#include "../StreamCounter1/src/int8_calibration.hpp"
+#include "../StreamCounter1/src/line_counter.hpp"
+#include "../StreamCounter1/src/model_cache.hpp"
+#include "../StreamCounter1/src/motion_gate.hpp"
+#include "../StreamCounter1/src/nms.hpp"
+#include "../StreamCounter1/src/nv12_preprocess.hpp"
+#include "../StreamCounter1/src/yolo_decoder.hpp"
+#include "../StreamCounter1/src/yolo_detector.hpp"
+#include "../StreamCounter1/src/zone_counter.hpp"
 // Link with SetupAPI, Cfgmgr32, and Media Foundation
 #pragma comment(lib, "SetupAPI.lib")
 #pragma comment(lib, "Cfgmgr32.lib")
@@ -35,6 +51,46 @@ DEFINE_GUID(GUID_DEVINTERFACE_USB_DEVICE,
     0xA5DCBF10L, 0x6530, 0x11D2,
     0x90, 0x1F, 0x00, 0xC0, 0x4F, 0xB9, 0x51, 0xED);
 
+// Triple buffer lock-free giua CaptureThread (producer) va WM_PAINT (consumer).
+// Producer ghi vao back buffer roi doi chi so voi middle bang 1 lenh atomic;
+// painter lay middle moi nhat lam front. Khong ben nao phai cho ben kia.
+struct DisplayTripleBuffer {
+    static constexpr int kDirty = 4; // Bit danh dau middle chua duoc painter lay
+
+    std::vector<BYTE> buffers[3];
+    int stride = 0;
+    int backIndex = 0;           // Chi CaptureThread
+    int frontIndex = 2;          // Chi UI thread
+    bool hasFront = false;       // Chi UI thread
+    std::atomic<int> middle{ 1 };
+
+    void Allocate(UINT32 width, UINT32 height)
+    {
+        stride = (width * 3 + 3) & ~3; // DIB yeu cau stride align 4 byte
+        for (auto& buffer : buffers)
+            buffer.assign((size_t)stride * height, 0);
+    }
+
+    BYTE* BackBuffer() { return buffers[backIndex].data(); }
+
+    // Producer: cong bo back buffer, nhan lai buffer cu cua middle de ghi tiep
+    void Publish()
+    {
+        backIndex = middle.exchange(backIndex | kDirty, std::memory_order_acq_rel) & 3;
+    }
+
+    // Consumer: lay frame moi nhat neu co, nguoc lai ve lai front hien tai
+    const BYTE* AcquireFront()
+    {
+        if (middle.load(std::memory_order_acquire) & kDirty)
+        {
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & 3;
+            hasFront = true;
+        }
+        return hasFront ? buffers[frontIndex].data() : nullptr;
+    }
+};
+
 // Global variables cho livestream
 struct LivestreamContext {
     HWND hwnd = nullptr;
@@ -43,26 +99,68 @@ struct LivestreamContext {
     UINT32 videoWidth = 0;
     UINT32 videoHeight = 0;
     BITMAPINFO bitmapInfo = {};
-    std::vector<BYTE> frameBuffer;
-    CRITICAL_SECTION cs;
+    DisplayTripleBuffer display;
 };
 
 LivestreamContext g_livestreamCtx;
 
 // Global variables cho YOLO inference
 struct YOLOConfig {
-    cv::dnn::Net net;
+    std::unique_ptr<InferenceBackend> backend; // OpenCV DNN hoac ONNX Runtime (--backend)
+    BackendKind backendKind = BackendKind::OpenCV;
     std::vector<std::string> classNames;
-    int inputSize = 640;
+    std::vector<std::string> classes{ "person" }; // Chi decode + NMS cac class nay (--classes a,b)
+    std::string countClass;   // --count-class; rong = person neu co trong classes, neu khong thi class dau tien
+    int countClassId = 0;     // Resolve trong LoadModel, truoc khi bat isLoaded
+    cv::Size inputSize{ 640, 640 }; // W x H (boi so cua 32); --input 640x384 cho camera 16:9
+    cv::Rect roi;                   // Vung dem (--roi x,y,w,h); rong = ca frame. Chi crop nay duoc forward
     float confThreshold = 0.5f;
     float nmsThreshold = 0.45f;
-    bool isLoaded = false;
+    std::atomic<bool> isLoaded{ false }; // Chi true sau khi load + warm-up xong (thread nen)
+    bool useInt8 = false;        // --int8: yolov8n_int8.onnx, hoac quantize tu AIStuff/calib
+    Nv12Preprocessor preprocess; // NV12 -> input letterbox cua backend, chi dung tu InferenceThread
+    YoloV8Decoder decoder;    // Chi dung tu InferenceThread
+    Nms nms{ 1000 };          // NMS theo class, toi da 1000 ung vien; giu capacity, khong cap phat sau warm-up
+    std::vector<int> indices; // Ket qua NMS, tai su dung moi frame
+    ByteTracker tracker;      // highScore mac dinh = confThreshold; Update o InferenceThread, Predict o CaptureThread (g_trackerMutex)
+    bool useFlow = false;     // --flow: giua 2 lan inference day box bang optical flow thay vi Kalman
+    FlowPropagator flow;      // Chi dung tu CaptureThread: seed tren frame moi nhat sau moi Update, roi Propagate
 };
 
 YOLOConfig g_yoloConfig;
-std::atomic<int> g_personCount{ 0 };
+std::atomic<int> g_personCount{ 0 };  // So nguoi dang co mat (track da xac nhan), khong phai so box cua 1 frame
+std::atomic<int> g_personUnique{ 0 }; // Tong so nguoi khac nhau da di qua tu luc bat dau
+std::vector<CountingLine> g_countingLines; // --line x1,y1,x2,y2 (lap lai duoc), toa do frame
+LineCounter g_lineCounter;                 // Dem vao/ra qua cac line; In()/Out() la atomic, doc tu CaptureThread
+std::vector<CountingZone> g_countingZones; // --zone x1,y1,x2,y2,x3,y3,... (lap lai duoc), toa do frame
+ZoneCounter g_zoneCounter;                 // So nguoi trong tung zone; Occupancy() la atomic
+std::mutex g_trackerMutex;                 // g_yoloConfig.tracker: Update o inference worker, Predict moi frame o CaptureThread
+std::atomic<LONGLONG> g_personCountTimestamp{ 0 }; // Timestamp (100ns) cua frame sinh ra g_personCount
 std::atomic<int> g_frameCounter{ 0 };
-const int g_inferenceSkipFrames = 3; // Chạy inference mỗi 3 frame
+// Chon khoang cach inference (moi N frame) theo latency forward va toc do capture.
+// Mac dinh: inference chiem toi da 50% thoi gian cua 1 core (--cpu-budget);
+// --latency-slo MS: count cu toi da MS ms. Tao trong wmain sau khi doc tham so.
+InferenceCadence::Config g_cadenceConfig;
+std::unique_ptr<InferenceCadence> g_inferenceCadence;
+
+// Bo qua inference khi Y plane gan nhu khong doi (camera tinh), giu lai count cu.
+// Chi dung tu CaptureThread.
+MotionGate g_motionGate;
+
+// Mailbox 1 slot giua CaptureThread va InferenceThread: capture luon ghi de
+// frame moi nhat, worker lay frame khi ranh. Frame cu chua xu ly bi bo qua,
+// nen capture khong bao gio phai doi forward pass.
+struct InferenceMailbox {
+    std::mutex mtx;
+    std::condition_variable cv;
+    cv::Mat frame;          // Slot frame moi nhat (NV12 tho, (h*3/2) x w)
+    LONGLONG timestamp = 0; // Timestamp cua frame trong slot
+    int64_t frameIndex = 0; // So thu tu frame (cung dem voi tracker.Predict())
+    bool hasFrame = false;
+    bool stop = false;
+};
+
+InferenceMailbox g_inferenceMailbox;
 
 // Thiết lập console để hiển thị Unicode
 void SetupConsole()
@@ -213,28 +311,63 @@ bool IsTargetCamera(const std::wstring& symbolicLink, const std::wstring& target
 }
 
 // Chuyển đổi NV12 sang RGB24
-// Tải model YOLO và class names
-bool LoadModel(const std::string& modelPath, const std::string& classNamesPath)
+// Thay g_yoloConfig.backend bang ban INT8: uu tien yolov8n_int8.onnx (pre-quantized)
+// canh model FP32, neu khong co thi quantize voi cac frame trong <AIStuff>/calib
+// (tao bang calibrate_int8 cua StreamCounter1). Quantize chi co voi backend opencv.
+bool LoadInt8Model(const std::string& modelPath)
+{
+    const std::string root = modelPath.substr(0, modelPath.find_last_of("/\\") + 1);
+    const std::string int8Path = root + "yolov8n_int8.onnx";
+    if (std::ifstream(int8Path).good())
+    {
+        std::unique_ptr<InferenceBackend> backend = CreateInferenceBackend(g_yoloConfig.backendKind);
+        if (backend && backend->Load(int8Path, g_yoloConfig.inputSize))
+        {
+            g_yoloConfig.backend = std::move(backend);
+            wprintf(L"[YOLO] Da tai model INT8: %hs\n", int8Path.c_str());
+            return true;
+        }
+    }
+
+    auto* opencv = dynamic_cast<OpenCvBackend*>(g_yoloConfig.backend.get());
+    std::vector<cv::Mat> frames;
+    if (!opencv || !LoadCalibrationFrames(root + "calib", frames))
+        return false;
+    cv::dnn::Net& net = opencv->Net();
+    if (!QuantizeNet(net, MakeCalibrationBlob(frames, g_yoloConfig.inputSize)))
+        return false;
+    net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    wprintf(L"[YOLO] Da quantize INT8 voi %zu frame calibration\n", frames.size());
+    return true;
+}
+
+// Tải model YOLO và class names. optimizedPath: ONNX Runtime ghi graph da
+// toi uu ra file nay (reuseOptimized = doc file nay thay vi parse ONNX);
+// backend opencv bo qua.
+bool LoadModel(const std::string& modelPath, const std::string& classNamesPath,
+               const std::string& optimizedPath = "", bool reuseOptimized = false)
 {
     try
     {
-        wprintf(L"[YOLO] Dang tai model: %hs\n", modelPath.c_str());
-        g_yoloConfig.net = cv::dnn::readNetFromONNX(modelPath);
-        
-        if (g_yoloConfig.net.empty())
+        wprintf(L"[YOLO] Dang tai model (%hs): %hs\n", BackendKindName(g_yoloConfig.backendKind), modelPath.c_str());
+        // Backend CPU (OpenCV DNN hoac ONNX Runtime, chon bang --backend)
+        g_yoloConfig.backend = CreateInferenceBackend(g_yoloConfig.backendKind);
+        if (g_yoloConfig.backend)
+            g_yoloConfig.backend->SetOptimizedCache(optimizedPath, reuseOptimized);
+        if (!g_yoloConfig.backend || !g_yoloConfig.backend->Load(modelPath, g_yoloConfig.inputSize))
         {
             wprintf(L"[YOLO] Loi: Khong the tai model!\n");
             return false;
         }
-
-        // Cau hinh backend (CPU by default, CUDA neu co)
-        g_yoloConfig.net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
-        g_yoloConfig.net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
-        // Neu co GPU: g_yoloConfig.net.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
-        // g_yoloConfig.net.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
+        if (g_yoloConfig.backend->LoadedOptimized())
+            wprintf(L"[YOLO] Dung model da toi uu: %hs\n", optimizedPath.c_str());
 
         wprintf(L"[YOLO] Da tai model thanh cong!\n");
 
+        if (g_yoloConfig.useInt8 && !LoadInt8Model(modelPath))
+            wprintf(L"[YOLO] Khong co INT8, chay FP32\n");
+
         // Tai class names
         std::ifstream ifs(classNamesPath);
         if (!ifs.is_open())
@@ -252,7 +385,33 @@ bool LoadModel(const std::string& modelPath, const std::string& classNamesPath)
         ifs.close();
 
         wprintf(L"[YOLO] Da tai %zu class names\n", g_yoloConfig.classNames.size());
-        g_yoloConfig.isLoaded = true;
+
+        // Decoder chi doc cac hang score cua class can dem thay vi ca 80 class
+        std::vector<int> classIds;
+        if (!ResolveClassIds(g_yoloConfig.classes, g_yoloConfig.classNames, classIds))
+            return false;
+        g_yoloConfig.decoder.SetClassFilter(classIds);
+
+        // Class dem (person, line, zone): --count-class, hoac person, hoac class dau tien cua --classes
+        int countClassId = 0;
+        if (!g_yoloConfig.countClass.empty())
+        {
+            std::vector<int> countId;
+            if (!ResolveClassIds({ g_yoloConfig.countClass }, g_yoloConfig.classNames, countId))
+                return false;
+            countClassId = countId[0];
+        }
+        if (!classIds.empty() && std::find(classIds.begin(), classIds.end(), countClassId) == classIds.end())
+        {
+            if (!g_yoloConfig.countClass.empty())
+            {
+                wprintf(L"[YOLO] Loi: Class dem %hs khong co trong --classes\n", g_yoloConfig.countClass.c_str());
+                return false;
+            }
+            countClassId = classIds[0];
+        }
+        g_yoloConfig.countClassId = countClassId;
+        wprintf(L"[YOLO] Dem class %hs\n", g_yoloConfig.classNames[countClassId].c_str());
 
         return true;
     }
@@ -263,83 +422,138 @@ bool LoadModel(const std::string& modelPath, const std::string& classNamesPath)
     }
 }
 
-// Inference va dem nguoi
-int RunInferenceAndCountPeople(cv::Mat& frame)
+// Chay tren thread nen trong luc wmain liet ke camera: tai model (duong dan
+// lan truoc trong model_cache.yml neu model khong doi, neu khong thi thu 3
+// duong dan AIStuff), chay forward gia de cap phat layer, roi moi bat
+// isLoaded de CaptureThread bat dau gui frame. Voi ONNX Runtime, graph da toi
+// uu duoc luu vao model_cache.ort va lan sau tai thang file do; OpenCV DNN
+// khong serialize duoc nen chi cache duong dan.
+void LoadModelAndWarmup()
 {
-    if (!g_yoloConfig.isLoaded)
-        return 0;
-
-    try
+    const char* cachePath = "model_cache.yml";
+    const std::string optimizedPath = "model_cache.ort";
+    const char* backendName = BackendKindName(g_yoloConfig.backendKind);
+    LONGLONG freq = 0, start = 0, now = 0;
+    QueryPerformanceFrequency(reinterpret_cast<LARGE_INTEGER*>(&freq));
+    QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&start));
+
+    ModelCache cache;
+    bool modelLoaded = ReadModelCache(cachePath, cache) &&
+        LoadModel(cache.modelPath, cache.classNamesPath, optimizedPath,
+                  cache.optimizedPath == optimizedPath && cache.backend == backendName);
+    if (!modelLoaded)
     {
-        // Resize va tao blob
-        cv::Mat blob = cv::dnn::blobFromImage(
-            frame,
-            1.0 / 255.0,
-            cv::Size(g_yoloConfig.inputSize, g_yoloConfig.inputSize),
-            cv::Scalar(0, 0, 0),
-            true,
-            false
-        );
+        // Cac duong dan co the (theo thu tu uu tien)
+        std::vector<std::string> modelPaths = {
+            "AIStuff/yolov8n.onnx",           // Relative: executable/../AIStuff
+            "../AIStuff/yolov8n.onnx",        // Relative: build/../AIStuff
+            "../../AIStuff/yolov8n.onnx",     // Relative: build/Release/../../AIStuff
+        };
+
+        std::vector<std::string> classNamesPaths = {
+            "AIStuff/coco.names",
+            "../AIStuff/coco.names",
+            "../../AIStuff/coco.names",
+        };
+
+        for (size_t i = 0; i < modelPaths.size() && !modelLoaded; i++)
+        {
+            g_yoloConfig.classNames.clear();
+            if (LoadModel(modelPaths[i], classNamesPaths[i], optimizedPath))
+            {
+                modelLoaded = true;
+                cache.modelPath = modelPaths[i];
+                cache.classNamesPath = classNamesPaths[i];
+            }
+        }
+    }
 
-        g_yoloConfig.net.setInput(blob);
+    if (!modelLoaded)
+    {
+        wprintf(L"[WARNING] Khong the tai model YOLO. Livestream se khong deem nguoi!\n");
+        return;
+    }
 
-        // Forward
-        std::vector<cv::Mat> outputs;
-        std::vector<std::string> outNames = g_yoloConfig.net.getUnconnectedOutLayersNames();
-        g_yoloConfig.net.forward(outputs, outNames);
+    QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&now));
+    cache.loadMs = (now - start) * 1000.0 / freq;
+    start = now;
 
-        // Parse outputs
-        std::vector<int> classIds;
-        std::vector<float> confidences;
-        std::vector<cv::Rect> boxes;
+    try
+    {
+        cache.forwardMs = g_yoloConfig.backend->Warmup(2);
+    }
+    catch (const std::exception& e)
+    {
+        wprintf(L"[YOLO] Warm-up loi: %hs\n", e.what());
+        return;
+    }
 
-        float scaleX = (float)frame.cols / g_yoloConfig.inputSize;
-        float scaleY = (float)frame.rows / g_yoloConfig.inputSize;
+    QueryPerformanceCounter(reinterpret_cast<LARGE_INTEGER*>(&now));
+    cache.warmupMs = (now - start) * 1000.0 / freq;
+    cache.backend = backendName;
+    cache.optimizedPath = g_yoloConfig.backend->OptimizedCache();
+    WriteModelCache(cachePath, cache);
 
-        for (const auto& output : outputs)
-        {
-            const float* data = (float*)output.data;
-            int rows = output.rows;
-            int cols = output.cols;
+    // CaptureThread goi Update/Count duoi g_trackerMutex ca truoc khi model san sang
+    {
+        std::lock_guard<std::mutex> lock(g_trackerMutex);
+        g_lineCounter.SetClassId(g_yoloConfig.countClassId);
+        g_zoneCounter.SetClassId(g_yoloConfig.countClassId);
+    }
 
-            for (int i = 0; i < rows; ++i)
-            {
-                cv::Mat scores = output.row(i).colRange(4, output.cols);
-                cv::Point classIdPoint;
-                double confidence;
-                minMaxLoc(scores, nullptr, &confidence, nullptr, &classIdPoint);
+    g_yoloConfig.isLoaded = true;
+    wprintf(L"[YOLO] San sang: load %.0f ms, warm-up %.0f ms, forward %.1f ms\n",
+            cache.loadMs, cache.warmupMs, cache.forwardMs);
+}
 
-                if (confidence > g_yoloConfig.confThreshold)
-                {
-                    int centerX = (int)(data[i * cols + 0] * scaleX);
-                    int centerY = (int)(data[i * cols + 1] * scaleY);
-                    int width = (int)(data[i * cols + 2] * scaleX);
-                    int height = (int)(data[i * cols + 3] * scaleY);
-                    int left = centerX - width / 2;
-                    int top = centerY - height / 2;
-
-                    classIds.push_back(classIdPoint.x);
-                    confidences.push_back((float)confidence);
-                    boxes.push_back(cv::Rect(left, top, width, height));
-                }
-            }
-        }
+// Inference va dem nguoi tren frame NV12 (Y plane + UV plane lien tiep)
+// frameIndex: frame da chup (g_frameCounter); tracker co the da Predict qua frame nay
+int RunInferenceAndCountPeople(const cv::Mat& nv12, int width, int height, int64_t frameIndex)
+{
+    if (!g_yoloConfig.isLoaded)
+        return 0;
 
-        // NMS
-        std::vector<int> indices;
-        cv::dnn::NMSBoxes(boxes, confidences, g_yoloConfig.confThreshold, g_yoloConfig.nmsThreshold, indices);
+    try
+    {
+        // Cua so con NV12 cua vung dem (khong copy), toa do chan de khop cap UV
+        const int stride = (int)nv12.step;
+        const uint8_t* yPlane = nv12.data;
+        const uint8_t* uvPlane = nv12.data + (size_t)height * stride;
+        const cv::Rect roi = AlignNv12Roi(g_yoloConfig.roi, width, height);
+        OffsetNv12Planes(roi, yPlane, stride, uvPlane, stride);
+
+        // NV12 -> RGB planar letterbox trong 1 lan duyet, ghi thang vao input cua backend
+        InferenceBackend& backend = *g_yoloConfig.backend;
+        Nv12Preprocessor& preprocess = g_yoloConfig.preprocess;
+        preprocess.Configure(roi.width, roi.height, g_yoloConfig.inputSize.width, g_yoloConfig.inputSize.height);
+        preprocess.RunInto(yPlane, stride, uvPlane, stride, backend.InputBuffer(1));
 
-        // Dem nguoi (class 0)
-        int personCount = 0;
-        for (int idx : indices)
-        {
-            if (classIds[idx] == 0) // class 0 = person
-            {
-                personCount++;
-            }
-        }
+        // Forward
+        backend.Forward(1);
+        const TensorView output = backend.Output(0);
+        if (!output.data || output.dims != 3 || output.shape[0] != 1)
+            return 0;
+
+        // Decode head YOLOv8 [1, 84, 8400] (channel-major) truc tiep tren tensor
+        BoxTransform transform = preprocess.Transform();
+        transform.originX = (float)roi.x; // Box ve toa do frame day du
+        transform.originY = (float)roi.y;
+        // Giu box tu lowScore cua tracker (pass 2 cua ByteTrack); confThreshold chi ap dung trong tracker (highScore)
+        ByteTracker& tracker = g_yoloConfig.tracker;
+        const float threshold = tracker.GetConfig().lowScore;
+        YoloV8Decoder& decoder = g_yoloConfig.decoder;
+        decoder.Decode(output.data, output.shape[1], output.shape[2], threshold, transform);
 
-        return personCount;
+        // NMS
+        std::vector<int>& indices = g_yoloConfig.indices;
+        g_yoloConfig.nms.Run(decoder.Boxes(), decoder.Scores(), decoder.ClassIds(), threshold, g_yoloConfig.nmsThreshold, indices);
+
+        // Tracker: dem nguoi dang co mat + tong so nguoi khac nhau (class 0 = person)
+        std::lock_guard<std::mutex> lock(g_trackerMutex);
+        tracker.Update(decoder.Boxes(), decoder.Scores(), decoder.ClassIds(), indices, frameIndex);
+        g_personUnique.store(tracker.UniqueCount(g_yoloConfig.countClassId));
+        g_lineCounter.Update(tracker);
+        return tracker.Occupancy(g_yoloConfig.countClassId);
     }
     catch (const std::exception& e)
     {
@@ -355,6 +569,67 @@ void ConvertNV12ToBGR(const BYTE* nv12Data, cv::Mat& bgrFrame, UINT32 width, UIN
     cv::cvtColor(nv12, bgrFrame, cv::COLOR_YUV2BGR_NV12);
 }
 
+// Gui frame vao mailbox cho inference worker (ghi de frame chua xu ly).
+// staging duoc copy ngoai lock roi swap vao slot, nen cac Mat duoc tai su dung
+// va capture chi giu lock trong luc swap.
+void PostFrameForInference(const cv::Mat& frame, LONGLONG timestamp, int64_t frameIndex, cv::Mat& staging)
+{
+    frame.copyTo(staging);
+    {
+        std::lock_guard<std::mutex> lock(g_inferenceMailbox.mtx);
+        std::swap(g_inferenceMailbox.frame, staging);
+        g_inferenceMailbox.timestamp = timestamp;
+        g_inferenceMailbox.frameIndex = frameIndex;
+        g_inferenceMailbox.hasFrame = true;
+    }
+    g_inferenceMailbox.cv.notify_one();
+}
+
+// Thread inference: lay frame moi nhat tu mailbox, chay YOLO va cong bo ket qua
+void InferenceThread()
+{
+    wprintf(L"[Inference] Bat dau inference thread...\n");
+
+    cv::Mat workFrame;
+    int inferenceCount = 0;
+
+    while (true)
+    {
+        LONGLONG timestamp = 0;
+        int64_t frameIndex = 0;
+        {
+            std::unique_lock<std::mutex> lock(g_inferenceMailbox.mtx);
+            g_inferenceMailbox.cv.wait(lock, [] {
+                return g_inferenceMailbox.hasFrame || g_inferenceMailbox.stop;
+            });
+            if (g_inferenceMailbox.stop)
+                break;
+
+            std::swap(workFrame, g_inferenceMailbox.frame);
+            timestamp = g_inferenceMailbox.timestamp;
+            frameIndex = g_inferenceMailbox.frameIndex;
+            g_inferenceMailbox.hasFrame = false;
+        }
+
+        auto inferenceStart = InferenceCadence::Clock::now();
+        int personCount = RunInferenceAndCountPeople(workFrame,
+            (int)g_livestreamCtx.videoWidth, (int)g_livestreamCtx.videoHeight, frameIndex);
+        g_inferenceCadence->OnInferenceDone(std::chrono::duration<double, std::milli>(
+            InferenceCadence::Clock::now() - inferenceStart).count());
+        g_personCountTimestamp.store(timestamp);
+        g_personCount.store(personCount);
+
+        if (++inferenceCount % 30 == 0)
+        {
+            wprintf(L"[Inference] %d people present, %d unique, in %u / out %u (ts=%lld) | moi %d frame, %.1f inf/s, %.1f ms\n",
+                personCount, g_personUnique.load(), g_lineCounter.TotalIn(), g_lineCounter.TotalOut(), timestamp, g_inferenceCadence->Interval(),
+                g_inferenceCadence->InferenceFps(), g_inferenceCadence->InferenceLatencyMs());
+        }
+    }
+
+    wprintf(L"[Inference] Ket thuc. Tong inference: %d\n", inferenceCount);
+}
+
 // Window procedure để xử lý sự kiện
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
@@ -365,21 +640,18 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
-        EnterCriticalSection(&g_livestreamCtx.cs);
-
-        if (!g_livestreamCtx.frameBuffer.empty())
+        const BYTE* front = g_livestreamCtx.display.AcquireFront();
+        if (front)
         {
             StretchDIBits(hdc,
                 0, 0, g_livestreamCtx.videoWidth, g_livestreamCtx.videoHeight,
                 0, 0, g_livestreamCtx.videoWidth, g_livestreamCtx.videoHeight,
-                g_livestreamCtx.frameBuffer.data(),
+                front,
                 &g_livestreamCtx.bitmapInfo,
                 DIB_RGB_COLORS,
                 SRCCOPY);
         }
 
-        LeaveCriticalSection(&g_livestreamCtx.cs);
-
         EndPaint(hwnd, &ps);
         return 0;
     }
@@ -402,7 +674,16 @@ void CaptureThread()
 {
     wprintf(L"[Thread] Bat dau capture thread...\n");
 
-    cv::Mat displayFrame;
+    cv::Mat inferenceStaging;
+    std::string countText;  // Chi format lai khi so nguoi doi
+    int shownCount = -1;
+    int shownUnique = -1;
+    std::string lineText;   // "In: x  Out: y", chi khi co --line
+    uint32_t shownIn = ~0u, shownOut = ~0u;
+    std::vector<std::string> zoneTexts(g_zoneCounter.Zones()); // "Z1: n" theo tung zone
+    std::vector<int> shownZone(g_zoneCounter.Zones(), -1);
+    std::vector<cv::Rect> trackBoxes; // box cua cac track da xac nhan, ve moi frame
+    trackBoxes.reserve(256);
     static int frameCount = 0;
     static bool firstFrame = true;
 
@@ -457,65 +738,141 @@ void CaptureThread()
                         firstFrame = false;
                     }
 
-                    // CONVERT NV12 -> BGR
+                    // CONVERT NV12 -> BGR truc tiep vao back buffer (DIB 24-bit luu B,G,R)
+                    DisplayTripleBuffer& display = g_livestreamCtx.display;
                     cv::Mat nv12(g_livestreamCtx.videoHeight + g_livestreamCtx.videoHeight / 2, 
                                  g_livestreamCtx.videoWidth, CV_8UC1, pData);
-                    cv::Mat bgrFrame;
-                    cv::cvtColor(nv12, bgrFrame, cv::COLOR_YUV2BGR_NV12);
-                    displayFrame = bgrFrame;
-
-                    pBuffer->Unlock();
+                    cv::Mat displayFrame(g_livestreamCtx.videoHeight, g_livestreamCtx.videoWidth,
+                                         CV_8UC3, display.BackBuffer(), display.stride);
+                    cv::cvtColor(nv12, displayFrame, cv::COLOR_YUV2BGR_NV12);
+
+                    // Gui NV12 tho cho inference worker moi N frame (N do g_inferenceCadence chon),
+                    // tru khi MotionGate thay Y plane khong doi so voi frame inference truoc.
+                    // Copy truoc Unlock: NV12 chi 1.5 byte/pixel so voi 3 byte cua BGR.
+                    const int64_t frameIndex = g_frameCounter.fetch_add(1) + 1;
+                    if (g_inferenceCadence->OnFrame() && g_yoloConfig.isLoaded &&
+                        g_motionGate.Check(pData, (int)g_livestreamCtx.videoWidth,
+                            (int)g_livestreamCtx.videoWidth, (int)g_livestreamCtx.videoHeight))
+                    {
+                        PostFrameForInference(nv12, timestamp, frameIndex, inferenceStaging);
+                    }
 
-                    // Inference moi N frame
-                    int currentFrame = g_frameCounter.fetch_add(1);
-                    if (currentFrame % g_inferenceSkipFrames == 0 && g_yoloConfig.isLoaded)
+                    // Giua 2 lan inference: Kalman (hoac optical flow voi --flow, tren Y plane nen
+                    // phai truoc Unlock) day box cua moi track them 1 frame, nen box, line va zone
+                    // van cap nhat theo FPS camera du YOLO chi chay moi N frame.
+                    // Predict ca khi model chua san sang, de tracker.Frame() luon bang frameIndex;
+                    // ket qua inference ve tre vai frame duoc hieu chinh tai frame da gui.
+                    // Sau moi Update, box da o frame hien tai (khong phai frame da inference), nen
+                    // flow seed tren Y plane cua frame nay; goodFeaturesToTrack chay ngoai lock.
+                    const cv::Mat yPlane = nv12.rowRange(0, g_livestreamCtx.videoHeight);
+                    FlowPropagator& flow = g_yoloConfig.flow;
+                    bool seedFlow = false;
+                    trackBoxes.clear();
                     {
-                        int personCount = RunInferenceAndCountPeople(displayFrame);
-                        g_personCount.store(personCount);
-                        
-                        if (currentFrame % 30 == 0)
+                        std::lock_guard<std::mutex> lock(g_trackerMutex);
+                        ByteTracker& tracker = g_yoloConfig.tracker;
+                        if (g_yoloConfig.useFlow && flow.NeedsSeed(tracker))
                         {
-                            wprintf(L"[Thread] Inference: %d people detected\n", personCount);
+                            tracker.Predict();
+                            flow.SeedBoxes(tracker);
+                            seedFlow = true;
+                        }
+                        else if (g_yoloConfig.useFlow)
+                            flow.Propagate(yPlane, tracker);
+                        else
+                            tracker.Predict();
+                        g_lineCounter.Update(tracker);
+                        g_zoneCounter.Prepare(cv::Size(displayFrame.cols, displayFrame.rows));
+                        g_zoneCounter.Count(tracker);
+                        for (int t = 0; t < tracker.Size(); t++)
+                        {
+                            if (tracker.Confirmed(t) && tracker.Lost(t) == 0)
+                                trackBoxes.push_back(tracker.Box(t));
                         }
                     }
+                    if (seedFlow)
+                        flow.SeedFeatures(yPlane);
+
+                    pBuffer->Unlock();
 
                     int personCount = g_personCount.load();
+                    int personUnique = g_personUnique.load();
+                    for (const cv::Rect& box : trackBoxes)
+                        cv::rectangle(displayFrame, box, cv::Scalar(0, 255, 0), 2);
 
-                    // Ve overlay
-                    cv::Rect overlayRect(10, 10, 200, 50);
-                    cv::Mat overlay = displayFrame.clone();
-                    cv::rectangle(overlay, overlayRect, cv::Scalar(0, 0, 0), -1);
-                    cv::addWeighted(overlay, 0.6, displayFrame, 0.4, 0, displayFrame);
+                    if (!g_yoloConfig.roi.empty())
+                    {
+                        cv::Rect zone = AlignNv12Roi(g_yoloConfig.roi, displayFrame.cols, displayFrame.rows);
+                        // 4 canh day 2px bang setTo: khong tao contour / buffer tam nhu cv::rectangle
+                        const cv::Rect frameRect(0, 0, displayFrame.cols, displayFrame.rows);
+                        const cv::Scalar zoneColor(0, 255, 255);
+                        displayFrame(cv::Rect(zone.x, zone.y, zone.width, 2) & frameRect).setTo(zoneColor);
+                        displayFrame(cv::Rect(zone.x, zone.br().y - 2, zone.width, 2) & frameRect).setTo(zoneColor);
+                        displayFrame(cv::Rect(zone.x, zone.y, 2, zone.height) & frameRect).setTo(zoneColor);
+                        displayFrame(cv::Rect(zone.br().x - 2, zone.y, 2, zone.height) & frameRect).setTo(zoneColor);
+                    }
 
-                    std::string countText = "People: " + std::to_string(personCount);
-                    cv::putText(displayFrame, countText, cv::Point(20, 45),
-                        cv::FONT_HERSHEY_SIMPLEX, 1.2, cv::Scalar(0, 255, 255), 2);
+                    for (int l = 0; l < g_lineCounter.Lines(); l++)
+                    {
+                        const CountingLine& line = g_lineCounter.Line(l);
+                        cv::line(displayFrame, line.a, line.b, cv::Scalar(255, 0, 255), 2);
+                    }
 
-                    // Convert BGR -> RGB24 de copy vao frameBuffer
-                    cv::Mat rgbFrame;
-                    cv::cvtColor(displayFrame, rgbFrame, cv::COLOR_BGR2RGB);
+                    for (int z = 0; z < g_zoneCounter.Zones(); z++)
+                    {
+                        const std::vector<cv::Point>& polygon = g_zoneCounter.Zone(z).polygon;
+                        cv::polylines(displayFrame, polygon, true, cv::Scalar(255, 255, 0), 2);
+                        int occupancy = g_zoneCounter.Occupancy(z);
+                        if (occupancy != shownZone[z])
+                        {
+                            char text[32];
+                            snprintf(text, sizeof(text), "Z%d: %d", z + 1, occupancy);
+                            zoneTexts[z] = text;
+                            shownZone[z] = occupancy;
+                        }
+                        cv::putText(displayFrame, zoneTexts[z], polygon[0] + cv::Point(5, 30),
+                            cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(255, 255, 0), 2);
+                    }
 
-                    // Copy vao frameBuffer
-                    EnterCriticalSection(&g_livestreamCtx.cs);
+                    // Ve overlay: lam toi 60% vung chu nhat (tuong duong addWeighted voi nen den)
+                    const int overlayHeight = g_lineCounter.Lines() > 0 ? 95 : 50;
+                    cv::Rect overlayRect = cv::Rect(10, 10, 560, overlayHeight) & cv::Rect(0, 0, displayFrame.cols, displayFrame.rows);
+                    cv::Mat overlayRoi = displayFrame(overlayRect);
+                    overlayRoi.convertTo(overlayRoi, -1, 0.4);
 
-                    int stride = (g_livestreamCtx.videoWidth * 3 + 3) & ~3;
+                    if (personCount != shownCount || personUnique != shownUnique)
+                    {
+                        char text[48];
+                        snprintf(text, sizeof(text), "People: %d  Total: %d", personCount, personUnique);
+                        countText = text;
+                        shownCount = personCount;
+                        shownUnique = personUnique;
+                    }
+                    cv::putText(displayFrame, countText, cv::Point(20, 45),
+                        cv::FONT_HERSHEY_SIMPLEX, 1.2, cv::Scalar(0, 255, 255), 2);
 
-                    if (g_livestreamCtx.frameBuffer.size() >= stride * g_livestreamCtx.videoHeight)
+                    if (g_lineCounter.Lines() > 0)
                     {
-                        for (UINT32 y = 0; y < g_livestreamCtx.videoHeight; y++)
-                        {
-                            BYTE* srcRow = rgbFrame.data + y * rgbFrame.step;
-                            BYTE* dstRow = g_livestreamCtx.frameBuffer.data() + y * stride;
-                            memcpy(dstRow, srcRow, g_livestreamCtx.videoWidth * 3);
-                        }
-                        
-                        if (frameCount % 30 == 0)
+                        uint32_t in = g_lineCounter.TotalIn(), out = g_lineCounter.TotalOut();
+                        if (in != shownIn || out != shownOut)
                         {
-                            wprintf(L"[Thread] Frame #%d copied to buffer\n", frameCount);
+                            char text[48];
+                            snprintf(text, sizeof(text), "In: %u  Out: %u", in, out);
+                            lineText = text;
+                            shownIn = in;
+                            shownOut = out;
                         }
+                        cv::putText(displayFrame, lineText, cv::Point(20, 90),
+                            cv::FONT_HERSHEY_SIMPLEX, 1.2, cv::Scalar(255, 0, 255), 2);
                     }
 
-                    LeaveCriticalSection(&g_livestreamCtx.cs);
+                    // Cong bo back buffer cho WM_PAINT (khong lock, khong copy)
+                    display.Publish();
+
+                    if (frameCount % 30 == 0)
+                    {
+                        wprintf(L"[Thread] Frame #%d published\n", frameCount);
+                    }
 
                     InvalidateRect(g_livestreamCtx.hwnd, nullptr, FALSE);
                 }
@@ -538,11 +895,15 @@ void CaptureThread()
             wprintf(L"[Thread] ERROR: ReadSample error\n");
             break;
         }
-
-        Sleep(33);
+        else
+        {
+            // ReadSample (sync) da block toi frame tiep theo; chi nghi khi khong co sample
+            Sleep(5);
+        }
     }
 
-    wprintf(L"[Thread] Ket thuc. Tong frame: %d\n", frameCount);
+    wprintf(L"[Thread] Ket thuc. Tong frame: %d, bo qua inference (khong chuyen dong): %llu\n",
+        frameCount, (unsigned long long)g_motionGate.SkippedFrames());
 }
 
 // Hiển thị livestream
@@ -617,12 +978,10 @@ HRESULT ShowLivestream(IMFActivate* pActivate)
     g_livestreamCtx.bitmapInfo.bmiHeader.biBitCount = 24;
     g_livestreamCtx.bitmapInfo.bmiHeader.biCompression = BI_RGB;
 
-    // Cấp phát buffer cho frame (align stride to 4 bytes)
-    int stride = (g_livestreamCtx.videoWidth * 3 + 3) & ~3;
-    g_livestreamCtx.frameBuffer.resize(stride * g_livestreamCtx.videoHeight);
+    // Cấp phát 3 buffer cho frame (align stride to 4 bytes)
+    g_livestreamCtx.display.Allocate(g_livestreamCtx.videoWidth, g_livestreamCtx.videoHeight);
 
     g_livestreamCtx.pReader = pReader;
-    InitializeCriticalSection(&g_livestreamCtx.cs);
 
     // Tạo window class
     WNDCLASSW wc = {};
@@ -660,6 +1019,8 @@ HRESULT ShowLivestream(IMFActivate* pActivate)
 
     // Bắt đầu capture thread
     g_livestreamCtx.isRunning = true;
+    g_inferenceMailbox.stop = false;
+    std::thread inferenceThread(InferenceThread);
     std::thread captureThread(CaptureThread);
 
     // Message loop
@@ -677,7 +1038,15 @@ HRESULT ShowLivestream(IMFActivate* pActivate)
         captureThread.join();
     }
 
-    DeleteCriticalSection(&g_livestreamCtx.cs);
+    {
+        std::lock_guard<std::mutex> lock(g_inferenceMailbox.mtx);
+        g_inferenceMailbox.stop = true;
+    }
+    g_inferenceMailbox.cv.notify_one();
+    if (inferenceThread.joinable())
+    {
+        inferenceThread.join();
+    }
 
     if (pReader) pReader->Release();
     if (pAttributes) pAttributes->Release();
@@ -688,11 +1057,131 @@ HRESULT ShowLivestream(IMFActivate* pActivate)
     return S_OK;
 }
 
-int wmain()
+int wmain(int argc, wchar_t* argv[])
 {
     // Thiết lập console
     SetupConsole();
 
+    for (int i = 1; i < argc; i++)
+    {
+        if (wcscmp(argv[i], L"--int8") == 0)
+        {
+            g_yoloConfig.useInt8 = true;
+        }
+        else if (wcscmp(argv[i], L"--backend") == 0 && i + 1 < argc)
+        {
+            // "opencv" (mac dinh) hoac "ort" (can build voi ONNX Runtime)
+            char name[32] = {};
+            wcstombs_s(nullptr, name, argv[++i], _TRUNCATE);
+            if (!ParseBackendKind(name, g_yoloConfig.backendKind))
+                wprintf(L"[YOLO] Backend khong hop le: %ls, dung opencv\n", argv[i]);
+        }
+        else if (wcscmp(argv[i], L"--classes") == 0 && i + 1 < argc)
+        {
+            // "person,car": danh sach ten class theo coco.names
+            char list[256] = {};
+            wcstombs_s(nullptr, list, argv[++i], _TRUNCATE);
+            if (!ParseClassList(list, g_yoloConfig.classes))
+                wprintf(L"[YOLO] Danh sach class khong hop le: %ls, dung tat ca class\n", argv[i]);
+        }
+        else if (wcscmp(argv[i], L"--count-class") == 0 && i + 1 < argc)
+        {
+            // "car": class duoc dem (person, line, zone), theo coco.names
+            char name[64] = {};
+            wcstombs_s(nullptr, name, argv[++i], _TRUNCATE);
+            g_yoloConfig.countClass = name;
+        }
+        else if (wcscmp(argv[i], L"--roi") == 0 && i + 1 < argc)
+        {
+            cv::Rect roi;
+            if (swscanf_s(argv[++i], L"%d,%d,%d,%d", &roi.x, &roi.y, &roi.width, &roi.height) == 4 && !roi.empty())
+                g_yoloConfig.roi = roi;
+        }
+        else if (wcscmp(argv[i], L"--line") == 0 && i + 1 < argc)
+        {
+            // "x1,y1,x2,y2": vao = di tu ben trai sang ben phai cua huong x1,y1 -> x2,y2
+            // (line ve tu trai sang phai: di xuong). Dem moi lan doi ben (cach line > 8 px)
+            char text[64] = {};
+            wcstombs_s(nullptr, text, argv[++i], _TRUNCATE);
+            CountingLine line;
+            line.classId = 0; // person; LoadModelAndWarmup doi sang class dem
+            if (ParseCountingLine(text, line))
+                g_countingLines.push_back(line);
+            else
+                wprintf(L"[Line] Line khong hop le: %ls\n", argv[i]);
+        }
+        else if (wcscmp(argv[i], L"--flow") == 0)
+        {
+            // Lucas-Kanade tren Y plane giua 2 lan inference (ton CPU hon Kalman, xem bench_interval)
+            g_yoloConfig.useFlow = true;
+        }
+        else if (wcscmp(argv[i], L"--zone") == 0 && i + 1 < argc)
+        {
+            // "x1,y1,x2,y2,x3,y3,...": da giac (>= 3 dinh); nguoi o trong zone khi chan (giua canh duoi box) nam trong
+            char text[256] = {};
+            wcstombs_s(nullptr, text, argv[++i], _TRUNCATE);
+            CountingZone zone;
+            zone.classId = 0; // person; LoadModelAndWarmup doi sang class dem
+            if (ParseCountingZone(text, zone))
+                g_countingZones.push_back(zone);
+            else
+                wprintf(L"[Zone] Zone khong hop le: %ls\n", argv[i]);
+        }
+        else if (wcscmp(argv[i], L"--cpu-budget") == 0 && i + 1 < argc)
+        {
+            // Ti le thoi gian 1 core danh cho inference, (0, 1]
+            double budget = _wtof(argv[++i]);
+            if (budget > 0.0 && budget <= 1.0)
+            {
+                g_cadenceConfig.policy = InferenceCadence::Policy::CpuBudget;
+                g_cadenceConfig.cpuBudget = budget;
+            }
+            else
+                wprintf(L"[Cadence] CPU budget khong hop le: %ls\n", argv[i]);
+        }
+        else if (wcscmp(argv[i], L"--latency-slo") == 0 && i + 1 < argc)
+        {
+            // Do tre toi da (ms) cua count: chon N lon nhat voi N * chu ky frame + latency <= MS
+            double sloMs = _wtof(argv[++i]);
+            if (sloMs > 0.0)
+            {
+                g_cadenceConfig.policy = InferenceCadence::Policy::LatencySlo;
+                g_cadenceConfig.latencySloMs = sloMs;
+            }
+            else
+                wprintf(L"[Cadence] Latency SLO khong hop le: %ls\n", argv[i]);
+        }
+        else if (wcscmp(argv[i], L"--input") == 0 && i + 1 < argc)
+        {
+            // "640" hoac "640x384"; lam tron len boi so cua 32 (stride YOLO)
+            int w = 0, h = 0;
+            int fields = swscanf_s(argv[++i], L"%dx%d", &w, &h);
+            if (fields >= 1 && w > 0)
+            {
+                if (fields < 2 || h <= 0)
+                    h = w;
+                g_yoloConfig.inputSize = cv::Size((w + 31) / 32 * 32, (h + 31) / 32 * 32);
+            }
+        }
+    }
+
+    g_inferenceCadence = std::make_unique<InferenceCadence>(g_cadenceConfig);
+    if (g_cadenceConfig.policy == InferenceCadence::Policy::LatencySlo)
+        wprintf(L"[Cadence] Latency SLO %.0f ms\n", g_cadenceConfig.latencySloMs);
+    else
+        wprintf(L"[Cadence] CPU budget %.0f%%\n", g_cadenceConfig.cpuBudget * 100.0);
+
+    if (!g_countingLines.empty())
+    {
+        g_lineCounter = LineCounter(g_countingLines);
+        wprintf(L"[Line] %d line dem vao/ra\n", g_lineCounter.Lines());
+    }
+    if (!g_countingZones.empty())
+    {
+        g_zoneCounter = ZoneCounter(g_countingZones);
+        wprintf(L"[Zone] %d zone dem so nguoi\n", g_zoneCounter.Zones());
+    }
+
     wprintf(L"===============================================================\n");
     wprintf(L"  USB CAMERA LIVESTREAM VIEWER - Camera 32E6:9221\n");
     wprintf(L"===============================================================\n\n");
@@ -722,36 +1211,10 @@ int wmain()
 
     wprintf(L"[OK] Da khoi tao Media Foundation thanh cong\n");
 
-    // Tai model YOLO (tim file relative voi executable hoac absolute)
-    wprintf(L"\n[*] Dang tai model YOLO...\n");
-    
-    // Cac duong dan co the (theo thu tu uu tien)
-    std::vector<std::string> modelPaths = {
-        "AIStuff/yolov8n.onnx",           // Relative: executable/../AIStuff
-        "../AIStuff/yolov8n.onnx",        // Relative: build/../AIStuff
-        "../../AIStuff/yolov8n.onnx",     // Relative: build/Release/../../AIStuff
-    };
-    
-    std::vector<std::string> classNamesPaths = {
-        "AIStuff/coco.names",
-        "../AIStuff/coco.names",
-        "../../AIStuff/coco.names",
-    };
-    
-    bool modelLoaded = false;
-    for (size_t i = 0; i < modelPaths.size(); i++)
-    {
-        if (LoadModel(modelPaths[i], classNamesPaths[i]))
-        {
-            modelLoaded = true;
-            break;
-        }
-    }
-    
-    if (!modelLoaded)
-    {
-        wprintf(L"[WARNING] Khong the tai model YOLO. Livestream se khong deem nguoi!\n");
-    }
+    // Tai + warm-up model YOLO tren thread nen, song song voi quet camera.
+    // Livestream van chay truoc khi model xong; dem nguoi bat dau khi isLoaded.
+    wprintf(L"\n[*] Dang tai model YOLO (nen)...\n");
+    std::thread modelThread(LoadModelAndWarmup);
 
     wprintf(L"\n[*] Dang quet cac thiet bi camera USB...\n\n");
 
@@ -762,6 +1225,7 @@ int wmain()
     if (FAILED(hr) || devices.empty())
     {
         wprintf(L"Khong tim thay camera nao!\n");
+        modelThread.join();
         MFShutdown();
         CoUninitialize();
         wprintf(L"\nNhan Enter de thoat...\n");
@@ -810,6 +1274,7 @@ int wmain()
     }
 
     // Cleanup
+    modelThread.join();
     for (auto device : devices)
     {
         device->Release();
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations made through global operator new and, with glibc,
+// through malloc / calloc / realloc / posix_memalign as well, so allocations
+// inside OpenCV and the inference runtimes show up too. The hooks live in
+// alloc_counter.cpp, which is linked only into benchmark / debug targets;
+// everything else keeps the default allocator.
+uint64_t AllocationCount();
@@ -0,0 +1,154 @@
+#include "bench_stats.hpp"
+#include "label_replay.hpp"
+#include "yolo_detector.hpp"
+
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// OpenCV DNN vs ONNX Runtime on the same frames: forward latency, whole
+// pipeline latency and count agreement, plus count error against the
+// predict4 labels when they are found (Video_<n>.txt is frame n, 1-based).
+//
+//   bench_backend [video] [--labels DIR] [--stem NAME] [--class ID] [--frames N]
+//                 [--input-size N|WxH]
+//
+// Both detectors load the same ONNX; ONNX Runtime must be compiled in
+// (HAVE_ONNXRUNTIME).
+
+namespace {
+
+struct Options {
+    std::string video = "Video.mp4";
+    std::string labelsDir = "runs/detect/predict4/labels";
+    std::string stem = "Video";
+    int classId = 2; // car
+    long maxFrames = 0;
+    cv::Size inputSize{ 640, 640 };
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.empty() || arg[0] != '-') {
+            opts.video = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--labels") {
+            opts.labelsDir = value;
+        } else if (arg == "--stem") {
+            opts.stem = value;
+        } else if (arg == "--class") {
+            opts.classId = std::atoi(value);
+        } else if (arg == "--frames") {
+            opts.maxFrames = std::atol(value);
+        } else if (arg == "--input-size") {
+            if (!ParseInputSize(value, opts.inputSize)) {
+                std::cerr << "Bad input size: " << value << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+struct BackendRun {
+    YoloDetector detector;
+    LatencyStats forward;
+    LatencyStats total;
+    double absError = 0.0;
+};
+
+void PrintRow(const BackendRun& r, long frames, bool haveLabels) {
+    std::cout << "  " << std::left << std::setw(11) << BackendKindName(r.detector.Config().backend) << std::right
+              << " forward mean " << std::setw(7) << r.forward.Mean()
+              << "  p50 " << std::setw(7) << r.forward.Percentile(50)
+              << "  p99 " << std::setw(7) << r.forward.Percentile(99)
+              << " ms   pipeline mean " << std::setw(7) << r.total.Mean() << " ms";
+    if (haveLabels)
+        std::cout << "   count MAE " << std::setw(5) << r.absError / frames;
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: bench_backend [video] [--labels DIR] [--stem NAME] [--class ID]"
+                     " [--frames N] [--input-size N|WxH]\n";
+        return 1;
+    }
+
+    LabelSequence labels;
+    const bool haveLabels = LoadLabelSequenceFromDefaultPaths(opts.labelsDir, opts.stem, labels);
+
+    cv::VideoCapture cap(opts.video);
+    if (!cap.isOpened()) {
+        std::cerr << "Cannot open " << opts.video << "\n";
+        return 1;
+    }
+
+    DetectorConfig config;
+    config.countClassId = opts.classId;
+    config.inputSize = opts.inputSize;
+    BackendRun runs[2];
+    const BackendKind kinds[2] = { BackendKind::OpenCV, BackendKind::OnnxRuntime };
+    for (int k = 0; k < 2; ++k) {
+        config.backend = kinds[k];
+        if (!LoadDetectorFromDefaultPaths(runs[k].detector, config)) {
+            std::cerr << "Cannot load YOLO model with " << BackendKindName(kinds[k]) << "\n";
+            return 1;
+        }
+        runs[k].detector.Backend().Warmup(2);
+    }
+
+    long agree = 0;
+    long frames = 0;
+    cv::Mat frame;
+    while ((!haveLabels || frames < (long)labels.size()) &&
+           (opts.maxFrames == 0 || frames < opts.maxFrames) && cap.read(frame)) {
+        int expected = 0;
+        if (haveLabels) {
+            for (const LabelBox& box : labels[frames])
+                expected += box.classId == opts.classId;
+        }
+
+        int counts[2];
+        for (int k = 0; k < 2; ++k) {
+            StageTimings t;
+            auto start = BenchClock::now();
+            counts[k] = runs[k].detector.CountObjects(frame, &t);
+            runs[k].total.Add(MsSince(start));
+            runs[k].forward.Add(t.forwardMs);
+            runs[k].absError += std::abs(counts[k] - expected);
+        }
+        agree += counts[0] == counts[1];
+        ++frames;
+    }
+    if (frames == 0) {
+        std::cerr << "No frames read from " << opts.video << "\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << frames << " frames of " << opts.video << " at " << opts.inputSize.width << "x"
+              << opts.inputSize.height << ", class " << opts.classId << "\n";
+    for (const BackendRun& r : runs)
+        PrintRow(r, frames, haveLabels);
+    std::cout << "  onnxruntime speedup " << runs[0].forward.Mean() / runs[1].forward.Mean()
+              << "x  counts identical on " << 100.0 * agree / frames << " % of frames\n";
+    return 0;
+}
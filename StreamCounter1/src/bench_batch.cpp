@@ -0,0 +1,172 @@
+#include "bench_stats.hpp"
+#include "inference_batcher.hpp"
+#include "inference_pool.hpp"
+#include "yolo_detector.hpp"
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Aggregate throughput of S camera streams: S independent batch-1 forwards
+// versus one InferenceBatcher forwarding up to S frames at a time, and an
+// InferencePool of M single-model instances with K threads each. Each
+// stream thread submits its next frame as soon as the previous result is
+// back, so the numbers are closed-loop frames/s across all streams.
+// Needs a model exported with a dynamic batch axis for batch > 1.
+//
+//   bench_batch [streams] [frames-per-stream] [max-wait-ms] [pool-instances] [pool-threads]
+//
+// pool-instances defaults to S, pool-threads to 1.
+
+namespace {
+
+cv::Mat MakeSyntheticNV12(int width, int height, uint64_t seed) {
+    cv::Mat nv12(height + height / 2, width, CV_8UC1);
+    cv::RNG rng(seed);
+    rng.fill(nv12.rowRange(0, height), cv::RNG::UNIFORM, 16, 236);
+    rng.fill(nv12.rowRange(height, nv12.rows), cv::RNG::UNIFORM, 64, 192);
+    return nv12;
+}
+
+struct StreamSync {
+    std::mutex mtx;
+    std::condition_variable cv;
+    long done = 0;
+    long failed = 0; // results without detections: the forward threw
+};
+
+double RunSequential(YoloDetector& detector, const std::vector<cv::Mat>& frames, int width,
+                     int height, int framesPerStream) {
+    const auto start = BenchClock::now();
+    for (int k = 0; k < framesPerStream; ++k) {
+        for (const cv::Mat& nv12 : frames)
+            detector.CountObjectsNV12(nv12.data, width, nv12.data + (size_t)width * height, width,
+                                      width, height);
+    }
+    return frames.size() * framesPerStream * 1000.0 / MsSince(start);
+}
+
+void OnResult(std::vector<StreamSync>& sync, const BatchResult& r) {
+    StreamSync& s = sync[r.streamId];
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        s.done++;
+        s.failed += r.detections ? 0 : 1;
+    }
+    s.cv.notify_one();
+}
+
+// Closed loop: each stream thread submits, waits for its result, repeats.
+// Returns aggregate frames/s.
+template <class Engine>
+double RunClosedLoop(Engine& engine, std::vector<StreamSync>& sync, const std::vector<cv::Mat>& frames,
+                     int width, int height, int framesPerStream) {
+    const int numStreams = (int)frames.size();
+    const auto start = BenchClock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numStreams; ++i) {
+        threads.emplace_back([&, i] {
+            const uint8_t* y = frames[i].data;
+            for (long k = 0; k < framesPerStream; ++k) {
+                engine.SubmitNV12(i, y, width, y + (size_t)width * height, width, width, height, k);
+                std::unique_lock<std::mutex> lock(sync[i].mtx);
+                sync[i].cv.wait(lock, [&] { return sync[i].done > k; });
+            }
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+    const double fps = numStreams * framesPerStream * 1000.0 / MsSince(start);
+    long failed = 0;
+    for (StreamSync& s : sync)
+        failed += s.failed;
+    if (failed > 0)
+        std::cerr << "  " << failed << " forwards failed\n";
+    return fps;
+}
+
+double RunBatched(YoloDetector& detector, const std::vector<cv::Mat>& frames, int width,
+                  int height, int framesPerStream, const InferenceBatcher::Config& config,
+                  double* meanBatch) {
+    std::vector<StreamSync> sync(frames.size());
+    InferenceBatcher batcher(detector.Backend(), detector.Config(), config,
+                             [&](const BatchResult& r) { OnResult(sync, r); });
+    for (size_t i = 0; i < frames.size(); ++i)
+        batcher.AddStream();
+    batcher.Start();
+    const double fps = RunClosedLoop(batcher, sync, frames, width, height, framesPerStream);
+    batcher.Stop();
+    *meanBatch = batcher.MeanBatchSize();
+    return fps;
+}
+
+double RunPooled(const DetectorConfig& detector, const std::vector<cv::Mat>& frames, int width,
+                 int height, int framesPerStream, const InferencePool::Config& config) {
+    std::vector<StreamSync> sync(frames.size());
+    InferencePool pool(config, [&](const BatchResult& r) { OnResult(sync, r); });
+    for (size_t i = 0; i < frames.size(); ++i)
+        pool.AddStream();
+    if (!pool.Start(detector))
+        return 0.0;
+    const double fps = RunClosedLoop(pool, sync, frames, width, height, framesPerStream);
+    pool.Stop();
+    return fps;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int numStreams = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4;
+    const int framesPerStream = argc > 2 ? std::max(1, std::atoi(argv[2])) : 50;
+    const double maxWaitMs = argc > 3 ? std::atof(argv[3]) : 10.0;
+    InferencePool::Config poolConfig;
+    poolConfig.instances = argc > 4 ? std::max(1, std::atoi(argv[4])) : numStreams;
+    poolConfig.threadsPerInstance = argc > 5 ? std::max(1, std::atoi(argv[5])) : 1;
+    const int width = 1920, height = 1080;
+
+    YoloDetector detector;
+    if (!LoadDetectorFromDefaultPaths(detector, DetectorConfig())) {
+        std::cerr << "Cannot load YOLO model\n";
+        return 1;
+    }
+
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < numStreams; ++i)
+        frames.push_back(MakeSyntheticNV12(width, height, 1000 + i));
+
+    // Warm up so the first batch does not pay for layer allocation
+    RunSequential(detector, frames, width, height, 1);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << numStreams << " streams x " << framesPerStream << " frames, " << width << "x"
+              << height << " -> " << detector.Config().inputSize << ", max wait " << maxWaitMs
+              << " ms\n";
+
+    const double sequential = RunSequential(detector, frames, width, height, framesPerStream);
+    std::cout << "  sequential batch-1    " << std::setw(8) << sequential << " frames/s\n";
+
+    double meanBatch = 0.0;
+    for (int maxBatch : { 1, numStreams }) {
+        InferenceBatcher::Config config;
+        config.maxBatch = maxBatch;
+        config.maxWaitMs = maxWaitMs;
+        const double fps = RunBatched(detector, frames, width, height, framesPerStream, config, &meanBatch);
+        std::cout << "  batcher max " << std::setw(2) << maxBatch << "        " << std::setw(8) << fps
+                  << " frames/s  mean batch " << meanBatch << "  speedup " << fps / sequential
+                  << "x\n";
+        if (maxBatch == numStreams)
+            break;
+    }
+
+    const double pooled = RunPooled(detector.Config(), frames, width, height, framesPerStream, poolConfig);
+    std::cout << "  pool " << std::setw(2) << poolConfig.instances << " x " << std::setw(2)
+              << poolConfig.threadsPerInstance << " threads  " << std::setw(8) << pooled
+              << " frames/s  speedup " << pooled / sequential << "x\n";
+    return 0;
+}
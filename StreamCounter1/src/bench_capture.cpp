@@ -0,0 +1,306 @@
+#include "bench_stats.hpp"
+#include "v4l2_capture.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// V4L2Capture against the OpenCV VideoCapture path: throughput and
+// per-frame wait, plus driver-to-consumer frame age where the driver has
+// monotonic timestamps.
+//
+//   bench_capture [--device /dev/videoN] [--size WxH] [--format nv12|yuyv]
+//                 [--buffers N] [--frames N] [--hold N] [--image PATH] [--clip N]
+//
+// With --device (a camera, or the vivid virtual driver: modprobe vivid) both
+// paths capture from it: V4L2Capture handing out mmap'd buffers in place,
+// and cv::VideoCapture(CAP_V4L2) with and without its BGR conversion.
+// Without a device it runs against a file-backed stand-in: --clip frames
+// panned across --image are written as raw frames for RawFileCapture and as
+// an MJPG AVI for cv::VideoCapture, the file path OpenCV would take. The
+// stand-in serves frames as fast as they are released, so it measures the
+// consumer-side cost of each path, not camera timing.
+// --hold N keeps the last N frames out (inference in flight) while the
+// next is acquired; 0 releases each frame at once. The acquire needs a free
+// buffer, so N is at most --buffers - 1.
+
+namespace {
+
+struct Options {
+    std::string device;
+    int width = 1280;
+    int height = 720;
+    PixelFormat format = PixelFormat::NV12;
+    int buffers = 4;
+    int frames = 300;
+    int hold = 1;
+    std::string image = "image.jpg";
+    int clip = 60;
+    std::string rawPath = "bench_capture.raw";
+    std::string aviPath = "bench_capture.avi";
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--device") {
+            opts.device = value;
+        } else if (arg == "--size") {
+            if (std::sscanf(value, "%dx%d", &opts.width, &opts.height) != 2)
+                return false;
+        } else if (arg == "--format") {
+            if (!ParsePixelFormat(value, opts.format) || opts.format == PixelFormat::MJPEG) {
+                std::cerr << "Format must be nv12 or yuyv\n";
+                return false;
+            }
+        } else if (arg == "--buffers") {
+            opts.buffers = std::max(2, std::atoi(value));
+        } else if (arg == "--frames") {
+            opts.frames = std::max(1, std::atoi(value));
+        } else if (arg == "--hold") {
+            opts.hold = std::max(0, std::atoi(value));
+        } else if (arg == "--image") {
+            opts.image = value;
+        } else if (arg == "--clip") {
+            opts.clip = std::max(1, std::atoi(value));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+struct RunResult {
+    int frames = 0;
+    double fps = 0.0;
+    LatencyStats wait; // ms blocked in Acquire / read
+    LatencyStats age;  // ms, driver timestamp -> dequeue
+    uint32_t dropped = 0;
+};
+
+// Acquire / Release loop over V4L2Capture or RawFileCapture; with bgr the
+// consumer converts each view to BGR, as CountObjects() callers would.
+template <class Capture>
+RunResult RunRaw(Capture& cap, const Options& opts, bool bgr) {
+    RunResult result;
+    std::deque<CapturedFrame> held;
+    cv::Mat converted;
+    const auto start = BenchClock::now();
+    for (int n = 0; n < opts.frames; ++n) {
+        const auto waitStart = BenchClock::now();
+        CapturedFrame frame;
+        if (!cap.Acquire(frame))
+            break;
+        result.wait.Add(MsSince(waitStart));
+        if (frame.ageMs > 0.0)
+            result.age.Add(frame.ageMs);
+        if (bgr)
+            cv::cvtColor(FrameView(frame), converted,
+                         frame.format == PixelFormat::NV12 ? cv::COLOR_YUV2BGR_NV12 : cv::COLOR_YUV2BGR_YUYV);
+        held.push_back(frame);
+        if ((int)held.size() > opts.hold) {
+            cap.Release(held.front());
+            held.pop_front();
+        }
+        ++result.frames;
+    }
+    for (const CapturedFrame& frame : held)
+        cap.Release(frame);
+    result.fps = result.frames * 1000.0 / MsSince(start);
+    return result;
+}
+
+RunResult RunOpenCV(cv::VideoCapture& cap, const Options& opts, bool rewind) {
+    RunResult result;
+    cv::Mat frame;
+    const auto start = BenchClock::now();
+    for (int n = 0; n < opts.frames; ++n) {
+        const auto waitStart = BenchClock::now();
+        if (!cap.read(frame) || frame.empty()) {
+            if (!rewind || !cap.set(cv::CAP_PROP_POS_FRAMES, 0) || !cap.read(frame) || frame.empty())
+                break;
+        }
+        result.wait.Add(MsSince(waitStart));
+        ++result.frames;
+    }
+    result.fps = result.frames * 1000.0 / MsSince(start);
+    return result;
+}
+
+void PrintRow(const char* name, const RunResult& r) {
+    std::cout << std::left << std::setw(18) << name << std::right << std::setw(7) << r.frames
+              << std::setw(9) << r.fps << std::setw(9) << r.wait.Mean() << std::setw(9) << r.wait.Percentile(99);
+    if (r.age.Count() > 0)
+        std::cout << std::setw(9) << r.age.Mean() << std::setw(9) << r.age.Percentile(99);
+    else
+        std::cout << std::setw(9) << "-" << std::setw(9) << "-";
+    std::cout << std::setw(8) << r.dropped << "\n";
+}
+
+void PrintHeader() {
+    std::cout << "path               frames      fps  wait ms      p99   age ms      p99  dropped\n";
+}
+
+// Packs BGR into NV12 or YUYV (BT.601, as cvtColor).
+void PackFrame(const cv::Mat& bgr, PixelFormat format, std::string& out) {
+    const int w = bgr.cols, h = bgr.rows;
+    if (format == PixelFormat::NV12) {
+        cv::Mat i420;
+        cv::cvtColor(bgr, i420, cv::COLOR_BGR2YUV_I420);
+        const uint8_t* y = i420.data;
+        const uint8_t* u = y + (size_t)w * h;
+        const uint8_t* v = u + (size_t)w * h / 4;
+        out.append(reinterpret_cast<const char*>(y), (size_t)w * h);
+        for (size_t i = 0; i < (size_t)w * h / 4; ++i) {
+            out.push_back((char)u[i]);
+            out.push_back((char)v[i]);
+        }
+    } else {
+        cv::Mat yuv;
+        cv::cvtColor(bgr, yuv, cv::COLOR_BGR2YUV);
+        for (int r = 0; r < h; ++r) {
+            const cv::Vec3b* p = yuv.ptr<cv::Vec3b>(r);
+            for (int c = 0; c + 1 < w; c += 2) {
+                out.push_back((char)p[c][0]);
+                out.push_back((char)p[c][1]);
+                out.push_back((char)p[c + 1][0]);
+                out.push_back((char)p[c][2]);
+            }
+        }
+    }
+}
+
+// Writes the stand-in clip: the image panned horizontally, 4 px a frame.
+bool WriteStandIn(const Options& opts) {
+    cv::Mat image = cv::imread(opts.image);
+    if (image.empty()) {
+        std::cerr << "Cannot read " << opts.image << "\n";
+        return false;
+    }
+    const int pan = 4 * opts.clip;
+    const double scale = std::max((double)(opts.width + pan) / image.cols, (double)opts.height / image.rows);
+    cv::resize(image, image, cv::Size(), scale, scale, cv::INTER_AREA);
+
+    std::ofstream raw(opts.rawPath, std::ios::binary);
+    cv::VideoWriter avi(opts.aviPath, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 30.0,
+                        cv::Size(opts.width, opts.height));
+    if (!raw || !avi.isOpened()) {
+        std::cerr << "Cannot write " << opts.rawPath << " / " << opts.aviPath << "\n";
+        return false;
+    }
+    std::string packed;
+    for (int f = 0; f < opts.clip; ++f) {
+        const cv::Mat frame = image(cv::Rect(4 * f, 0, opts.width, opts.height)).clone();
+        packed.clear();
+        PackFrame(frame, opts.format, packed);
+        raw.write(packed.data(), (std::streamsize)packed.size());
+        avi.write(frame);
+    }
+    return (bool)raw;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts) || opts.hold >= opts.buffers || opts.width % 2 || opts.height % 2) {
+        std::cerr << "Usage: bench_capture [--device /dev/videoN] [--size WxH] [--format nv12|yuyv]"
+                     " [--buffers N] [--frames N] [--hold N] [--image PATH] [--clip N]\n"
+                     "(even size, --hold at most --buffers - 1)\n";
+        return 1;
+    }
+
+    V4L2Capture::Config config;
+    config.width = opts.width;
+    config.height = opts.height;
+    config.format = opts.format;
+    config.buffers = opts.buffers;
+    std::cout << std::fixed << std::setprecision(2);
+
+    if (!opts.device.empty()) {
+        RunResult view, bgr;
+        {
+            V4L2Capture cap;
+            if (!cap.Open(opts.device, config))
+                return 1;
+            std::cout << opts.device << ": " << cap.Width() << "x" << cap.Height() << " "
+                      << PixelFormatName(cap.Format()) << ", " << cap.Buffers() << " mmap buffers, hold "
+                      << opts.hold << "\n\n";
+            view = RunRaw(cap, opts, false);
+            view.dropped = cap.Dropped();
+            const uint32_t before = cap.Dropped();
+            bgr = RunRaw(cap, opts, true);
+            bgr.dropped = cap.Dropped() - before;
+        }
+
+        const int fourcc = opts.format == PixelFormat::NV12 ? cv::VideoWriter::fourcc('N', 'V', '1', '2')
+                                                            : cv::VideoWriter::fourcc('Y', 'U', 'Y', 'V');
+        RunResult opencv[2];
+        for (int convert = 1; convert >= 0; --convert) {
+            cv::VideoCapture cap(opts.device, cv::CAP_V4L2);
+            if (!cap.isOpened()) {
+                std::cerr << "OpenCV cannot open " << opts.device << "\n";
+                return 1;
+            }
+            cap.set(cv::CAP_PROP_FOURCC, fourcc);
+            cap.set(cv::CAP_PROP_FRAME_WIDTH, opts.width);
+            cap.set(cv::CAP_PROP_FRAME_HEIGHT, opts.height);
+            cap.set(cv::CAP_PROP_BUFFERSIZE, opts.buffers);
+            cap.set(cv::CAP_PROP_CONVERT_RGB, convert);
+            opencv[convert] = RunOpenCV(cap, opts, false);
+        }
+
+        PrintHeader();
+        PrintRow("v4l2 view", view);
+        PrintRow("v4l2 + bgr", bgr);
+        PrintRow("opencv bgr", opencv[1]);
+        PrintRow("opencv raw", opencv[0]);
+        return 0;
+    }
+
+    if (!WriteStandIn(opts))
+        return 1;
+    RawFileCapture raw;
+    if (!raw.Open(opts.rawPath, config))
+        return 1;
+    cv::VideoCapture avi(opts.aviPath);
+    if (!avi.isOpened()) {
+        std::cerr << "OpenCV cannot open " << opts.aviPath << "\n";
+        return 1;
+    }
+    std::cout << "No --device: file stand-in, " << raw.Frames() << " frames " << opts.width << "x" << opts.height
+              << " " << PixelFormatName(opts.format) << " (" << opts.rawPath << ") vs MJPG (" << opts.aviPath
+              << "), " << opts.buffers << " slots, hold " << opts.hold << "\n\n";
+
+    // One untimed pass faults the mapping in, as a driver's buffers would be
+    RunRaw(raw, opts, false);
+    const RunResult view = RunRaw(raw, opts, false);
+    const RunResult bgr = RunRaw(raw, opts, true);
+    const RunResult opencv = RunOpenCV(avi, opts, true);
+
+    PrintHeader();
+    PrintRow("file view", view);
+    PrintRow("file + bgr", bgr);
+    PrintRow("opencv avi bgr", opencv);
+    // The stand-in loops, so a short pass means the hold left no free slot
+    if (view.frames < opts.frames || bgr.frames < opts.frames) {
+        std::cerr << "RawFileCapture stopped after " << std::min(view.frames, bgr.frames) << " of "
+                  << opts.frames << " frames\n";
+        return 1;
+    }
+    return 0;
+}
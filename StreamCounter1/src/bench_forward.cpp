@@ -0,0 +1,73 @@
+#include "bench_stats.hpp"
+#include "letterbox.hpp"
+#include "yolo_detector.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Forward-pass time per network input size, plus how much of each input a
+// 16:9 frame leaves as letterbox padding.
+//
+//   bench_forward [iterations] [WxH...]      (default 640x640 640x384 416x256)
+//
+// Non-square sizes need yolov8n.onnx exported with dynamic axes (or at that
+// size); sizes the model rejects are reported and skipped.
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    std::vector<cv::Size> sizes;
+    for (int i = 2; i < argc; ++i) {
+        cv::Size size;
+        if (!ParseInputSize(argv[i], size)) {
+            std::cerr << "Bad input size: " << argv[i] << "\n";
+            return 1;
+        }
+        sizes.push_back(size);
+    }
+    if (sizes.empty())
+        sizes = { { 640, 640 }, { 640, 384 }, { 416, 256 } };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Forward, " << iterations << " iterations per size (1920x1080 source)\n";
+    double baseline = 0.0;
+    for (const cv::Size& size : sizes) {
+        const LetterboxGeometry g = ComputeLetterbox(1920, 1080, size.width, size.height);
+        const double padding = 1.0 - (double)g.innerWidth * g.innerHeight / size.area();
+
+        DetectorConfig config;
+        config.inputSize = size;
+        YoloDetector detector;
+        if (!LoadDetectorFromDefaultPaths(detector, config)) {
+            std::cerr << "Cannot load YOLO model\n";
+            return 1;
+        }
+
+        LatencyStats stats(iterations);
+        try {
+            InferenceBackend& backend = detector.Backend();
+            backend.Warmup(2); // leaves the input letterbox-grey
+            for (int i = 0; i < iterations; ++i) {
+                auto start = BenchClock::now();
+                backend.Forward(1);
+                stats.Add(MsSince(start));
+            }
+        } catch (const std::exception& e) {
+            std::cout << "  " << size.width << "x" << size.height << "  rejected by model: " << e.what() << "\n";
+            continue;
+        }
+        if (baseline == 0.0)
+            baseline = stats.Mean();
+
+        std::cout << "  " << std::setw(4) << size.width << "x" << std::left << std::setw(4) << size.height
+                  << std::right << "  mean " << std::setw(7) << stats.Mean()
+                  << "  p50 " << std::setw(7) << stats.Percentile(50)
+                  << "  p99 " << std::setw(7) << stats.Percentile(99) << " ms"
+                  << "  padding " << std::setw(5) << padding * 100.0 << " %"
+                  << "  vs first " << std::setw(5) << baseline / stats.Mean() << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include "bench_stats.hpp"
+#include "label_replay.hpp"
+#include "yolo_detector.hpp"
+
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// FP32 vs INT8 on Video.mp4: forward latency and per-frame count error
+// against the predict4 labels (Video_<n>.txt is frame n, 1-based).
+//
+//   bench_int8 [video] [--labels DIR] [--stem NAME] [--class ID] [--frames N]
+//
+// INT8 uses AIStuff/yolov8n_int8.onnx if present, else AIStuff/calib
+// (see calibrate_int8).
+
+namespace {
+
+struct Options {
+    std::string video = "Video.mp4";
+    std::string labelsDir = "runs/detect/predict4/labels";
+    std::string stem = "Video";
+    int classId = 2; // car
+    long maxFrames = 0;
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.empty() || arg[0] != '-') {
+            opts.video = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--labels") {
+            opts.labelsDir = value;
+        } else if (arg == "--stem") {
+            opts.stem = value;
+        } else if (arg == "--class") {
+            opts.classId = std::atoi(value);
+        } else if (arg == "--frames") {
+            opts.maxFrames = std::atol(value);
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Accuracy {
+    LatencyStats forward;
+    double absError = 0.0;
+    long exact = 0;
+};
+
+void PrintRow(const char* name, const Accuracy& a, long frames) {
+    std::cout << "  " << std::left << std::setw(5) << name << std::right
+              << " forward mean " << std::setw(7) << a.forward.Mean()
+              << "  p50 " << std::setw(7) << a.forward.Percentile(50)
+              << " ms   count MAE " << std::setw(5) << a.absError / frames
+              << "  exact " << std::setw(6) << 100.0 * a.exact / frames << " %\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: bench_int8 [video] [--labels DIR] [--stem NAME] [--class ID] [--frames N]\n";
+        return 1;
+    }
+
+    LabelSequence labels;
+    if (!LoadLabelSequenceFromDefaultPaths(opts.labelsDir, opts.stem, labels)) {
+        std::cerr << "No label files found in " << opts.labelsDir << "\n";
+        return 1;
+    }
+
+    cv::VideoCapture cap(opts.video);
+    if (!cap.isOpened()) {
+        std::cerr << "Cannot open " << opts.video << "\n";
+        return 1;
+    }
+
+    DetectorConfig config;
+    config.countClassId = opts.classId;
+    YoloDetector fp32, int8;
+    if (!LoadDetectorFromDefaultPaths(fp32, config)) {
+        std::cerr << "Cannot load YOLO model\n";
+        return 1;
+    }
+    config.precision = ModelPrecision::INT8;
+    if (!LoadDetectorFromDefaultPaths(int8, config) || int8.Precision() != ModelPrecision::INT8) {
+        std::cerr << "INT8 model unavailable (run calibrate_int8 first)\n";
+        return 1;
+    }
+
+    Accuracy fp32Acc, int8Acc;
+    long agree = 0;
+    long frames = 0;
+    cv::Mat frame;
+    while (frames < (long)labels.size() && (opts.maxFrames == 0 || frames < opts.maxFrames) &&
+           cap.read(frame)) {
+        int expected = 0;
+        for (const LabelBox& box : labels[frames])
+            expected += box.classId == opts.classId;
+
+        StageTimings t;
+        const int a = fp32.CountObjects(frame, &t);
+        fp32Acc.forward.Add(t.forwardMs);
+        fp32Acc.absError += std::abs(a - expected);
+        fp32Acc.exact += a == expected;
+
+        const int b = int8.CountObjects(frame, &t);
+        int8Acc.forward.Add(t.forwardMs);
+        int8Acc.absError += std::abs(b - expected);
+        int8Acc.exact += b == expected;
+
+        agree += a == b;
+        ++frames;
+    }
+    if (frames == 0) {
+        std::cerr << "No frames read from " << opts.video << "\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << frames << " frames of " << opts.video << ", class " << opts.classId << " vs "
+              << opts.labelsDir << "\n";
+    PrintRow("FP32", fp32Acc, frames);
+    PrintRow("INT8", int8Acc, frames);
+    std::cout << "  INT8 speedup " << fp32Acc.forward.Mean() / int8Acc.forward.Mean()
+              << "x  MAE delta " << (int8Acc.absError - fp32Acc.absError) / frames
+              << "  counts identical to FP32 on " << 100.0 * agree / frames << " % of frames\n";
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include "bench_stats.hpp"
+#include "byte_tracker.hpp"
+#include "flow_propagator.hpp"
+#include "label_replay.hpp"
+#include "line_counter.hpp"
+#include "nms.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// What running inference only every N frames costs in counting fidelity.
+// The predict4 labels stand in for the detector: on inferred frames their
+// synthesized candidates go through NMS into the tracker; on the frames in
+// between the tracker either holds its boxes ("hold"), advances its Kalman
+// filters ("kalman") or follows Lucas-Kanade flow ("flow", FlowPropagator).
+// For each interval the tracked boxes are scored against the labels of every
+// frame (mean centre distance to the nearest label of the class), alongside
+// the unique and line counts and the CPU per frame: tracking work as
+// measured, plus the inferences at --forward-ms each (take it from
+// bench_forward on the target).
+//
+// The flow mode needs pixels: frames are rendered from the labels, a static
+// noise background with every labelled box filled by a noise texture
+// anchored at its top-left corner, so box content moves with the label.
+//
+//   bench_interval [--labels DIR] [--stem NAME] [--size WxH] [--candidates N]
+//                  [--class ID] [--line x1,y1,x2,y2] [--max-interval N] [--speed K]
+//                  [--forward-ms X]
+//
+// --speed K replays every K-th label frame, i.e. objects moving K times faster.
+
+namespace {
+
+struct Options {
+    std::string labelsDir = "runs/detect/predict4/labels";
+    std::string stem = "Video";
+    int width = 1920;
+    int height = 1080;
+    int candidatesPerLabel = 8;
+    int classId = 2; // car
+    std::string line; // empty = horizontal at 65% of the height
+    int maxInterval = 10;
+    int speed = 1;
+    double forwardMs = 30.0;
+    float nmsThreshold = 0.45f;
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--labels") {
+            opts.labelsDir = value;
+        } else if (arg == "--stem") {
+            opts.stem = value;
+        } else if (arg == "--size") {
+            if (std::sscanf(value, "%dx%d", &opts.width, &opts.height) != 2)
+                return false;
+        } else if (arg == "--candidates") {
+            opts.candidatesPerLabel = std::max(1, std::atoi(value));
+        } else if (arg == "--class") {
+            opts.classId = std::atoi(value);
+        } else if (arg == "--line") {
+            opts.line = value;
+        } else if (arg == "--max-interval") {
+            opts.maxInterval = std::max(1, std::atoi(value));
+        } else if (arg == "--speed") {
+            opts.speed = std::max(1, std::atoi(value));
+        } else if (arg == "--forward-ms") {
+            opts.forwardMs = std::max(0.0, std::atof(value));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+enum class Between { Hold, Kalman, Flow };
+
+const char* BetweenName(Between between) {
+    switch (between) {
+    case Between::Hold: return "hold";
+    case Between::Kalman: return "kalman";
+    default: return "flow";
+    }
+}
+
+cv::Mat NoiseTexture(cv::Size size, cv::RNG& rng) {
+    cv::Mat texture(size, CV_8U);
+    rng.fill(texture, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(texture, texture, cv::Size(0, 0), 1.5);
+    cv::normalize(texture, texture, 0, 255, cv::NORM_MINMAX);
+    return texture;
+}
+
+// Grey frames for the flow mode, see the top of the file.
+class LabelRenderer {
+public:
+    LabelRenderer(const Options& opts, cv::RNG& rng)
+        : opts_(opts), background_(NoiseTexture(cv::Size(opts.width, opts.height), rng)),
+          object_(NoiseTexture(cv::Size(opts.width, opts.height), rng)) {}
+
+    const cv::Mat& Render(const std::vector<LabelBox>& labels) {
+        background_.copyTo(frame_);
+        const cv::Rect bounds(0, 0, opts_.width, opts_.height);
+        for (const LabelBox& label : labels) {
+            const cv::Rect box = LabelToRect(label, opts_.width, opts_.height) & bounds;
+            if (!box.empty())
+                object_(cv::Rect(0, 0, box.width, box.height)).copyTo(frame_(box));
+        }
+        return frame_;
+    }
+
+private:
+    const Options& opts_;
+    cv::Mat background_, object_, frame_;
+};
+
+struct RunResult {
+    double meanError = 0.0; // px
+    int unique = 0;
+    uint32_t in = 0, out = 0;
+    int inferences = 0;
+    double usPerFrame = 0.0; // tracking work, excluding NMS and rendering
+};
+
+// Mean distance from each matched, confirmed track to the nearest label centre.
+double FrameError(const ByteTracker& tracker, const std::vector<cv::Point2f>& truth, int& samples) {
+    double sum = 0.0;
+    for (int t = 0; t < tracker.Size(); ++t) {
+        if (!tracker.Confirmed(t) || tracker.Lost(t) > 0)
+            continue;
+        const cv::Point2f c = tracker.Center(t);
+        float best = 1e9f;
+        for (const cv::Point2f& p : truth)
+            best = std::min(best, std::hypot(c.x - p.x, c.y - p.y));
+        if (best < 1e9f) {
+            sum += best;
+            ++samples;
+        }
+    }
+    return sum;
+}
+
+RunResult Run(const std::vector<CandidateFrame>& candidates, const std::vector<std::vector<cv::Point2f>>& truth,
+              const std::vector<const std::vector<LabelBox>*>& frameLabels, LabelRenderer& renderer,
+              const Options& opts, const CountingLine& line, int interval, Between between) {
+    Nms nms;
+    ByteTracker tracker;
+    FlowPropagator flow;
+    LineCounter lineCounter({ line });
+    std::vector<int> indices;
+    RunResult result;
+    double errorSum = 0.0;
+    int samples = 0;
+    double trackMs = 0.0;
+
+    for (size_t f = 0; f < candidates.size(); ++f) {
+        const CandidateFrame& frame = candidates[f];
+        const bool infer = f % interval == 0;
+        const cv::Mat* grey = nullptr;
+        if (between == Between::Flow && interval > 1)
+            grey = &renderer.Render(*frameLabels[f]);
+        if (infer) {
+            // Down to lowScore: the tracker applies the high threshold itself
+            nms.Run(frame.boxes, frame.scores, frame.classIds, tracker.GetConfig().lowScore, opts.nmsThreshold,
+                    indices);
+            ++result.inferences;
+        }
+        const auto start = BenchClock::now();
+        if (infer) {
+            tracker.Update(frame.boxes, frame.scores, frame.classIds, indices, (int64_t)f);
+            if (grey)
+                flow.Seed(*grey, tracker);
+        } else if (between == Between::Kalman) {
+            tracker.Predict();
+        } else if (between == Between::Flow) {
+            flow.Propagate(*grey, tracker);
+        }
+        lineCounter.Update(tracker);
+        trackMs += MsSince(start);
+        errorSum += FrameError(tracker, truth[f], samples);
+    }
+
+    result.meanError = samples > 0 ? errorSum / samples : 0.0;
+    result.unique = tracker.UniqueCount(opts.classId);
+    result.in = lineCounter.In(0);
+    result.out = lineCounter.Out(0);
+    result.usPerFrame = trackMs * 1000.0 / std::max<size_t>(1, candidates.size());
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: bench_interval [--labels DIR] [--stem NAME] [--size WxH] [--candidates N]"
+                     " [--class ID] [--line x1,y1,x2,y2] [--max-interval N] [--speed K]\n";
+        return 1;
+    }
+
+    CountingLine line;
+    if (opts.line.empty()) {
+        const float y = 0.65f * opts.height;
+        line.a = cv::Point2f(0.f, y);
+        line.b = cv::Point2f((float)opts.width, y);
+    } else if (!ParseCountingLine(opts.line, line)) {
+        std::cerr << "Bad counting line: " << opts.line << "\n";
+        return 1;
+    }
+    line.classId = opts.classId;
+
+    LabelSequence labels;
+    if (!LoadLabelSequenceFromDefaultPaths(opts.labelsDir, opts.stem, labels)) {
+        std::cerr << "No label files found in " << opts.labelsDir << "\n";
+        return 1;
+    }
+
+    std::vector<CandidateFrame> candidates;
+    std::vector<std::vector<cv::Point2f>> truth;
+    std::vector<const std::vector<LabelBox>*> frameLabels;
+    cv::RNG rng(0x5eed);
+    LabelRenderer renderer(opts, rng);
+    for (size_t f = 0; f < labels.size(); f += opts.speed) {
+        frameLabels.push_back(&labels[f]);
+        candidates.emplace_back();
+        SynthesizeCandidates(labels[f], opts.width, opts.height, opts.candidatesPerLabel, rng, candidates.back());
+        truth.emplace_back();
+        for (const LabelBox& label : labels[f]) {
+            if (label.classId == opts.classId)
+                truth.back().emplace_back(label.cx * opts.width, label.cy * opts.height);
+        }
+    }
+    std::cout << "Replaying " << candidates.size() << " frames (every " << opts.speed << " of "
+              << labels.size() << "), line (" << line.a.x << "," << line.a.y << ")-(" << line.b.x << ","
+              << line.b.y << ")\n\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "interval  infer  mode     err px  unique  in/out  track us/frame  est ms/frame\n";
+    for (int interval = 1; interval <= opts.maxInterval; ++interval) {
+        for (Between between : { Between::Hold, Between::Kalman, Between::Flow }) {
+            const RunResult r = Run(candidates, truth, frameLabels, renderer, opts, line, interval, between);
+            const double estMs = r.inferences * opts.forwardMs / candidates.size() + r.usPerFrame / 1000.0;
+            std::cout << std::setw(8) << interval << std::setw(7) << r.inferences << "  " << std::left
+                      << std::setw(7) << BetweenName(between) << std::right << std::setw(8) << r.meanError
+                      << std::setw(8) << r.unique << std::setw(5) << r.in << "/" << r.out << std::setw(16)
+                      << r.usPerFrame << std::setw(14) << estMs << "\n";
+        }
+    }
+    return 0;
+}
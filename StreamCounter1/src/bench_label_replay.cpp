@@ -0,0 +1,264 @@
+#include "alloc_counter.hpp"
+#include "bench_stats.hpp"
+#include "byte_tracker.hpp"
+#include "label_replay.hpp"
+#include "line_counter.hpp"
+#include "nms.hpp"
+#include "zone_counter.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Model-free throughput baseline for everything downstream of net.forward.
+// The predict4 label files are expanded into raw, pre-NMS candidates once,
+// then replayed through NMS -> track -> count as fast as possible. Each
+// repeat starts a fresh tracker, so unique counts are per pass.
+//
+// The counting line (default: horizontal at 65% of the height, which the
+// predict4 cars cross heading down) is checked against a reference pass
+// that tracks the clean labels themselves, without synthetic duplicates. The
+// zone (default: the left lane around the line) is counted from the
+// label-image lookup and checked against cv::pointPolygonTest on every box.
+//
+// NMS keeps boxes down to the tracker's lowScore, as stream_counter does;
+// counts and zones take those above confThreshold. --low-rate is the share
+// of labels whose best candidate scores under confThreshold (partly
+// occluded objects), which only the tracker's low-score pass can match.
+//
+//   bench_label_replay [--labels DIR] [--stem NAME] [--repeat N]
+//                      [--size WxH] [--candidates N] [--class ID]
+//                      [--line x1,y1,x2,y2] [--zone x1,y1,x2,y2,x3,y3,...]
+//                      [--low-rate R]
+
+namespace {
+
+struct Options {
+    std::string labelsDir = "runs/detect/predict4/labels";
+    std::string stem = "Video";
+    int repeat = 50;
+    int width = 1920;
+    int height = 1080;
+    int candidatesPerLabel = 8;
+    int classId = 2; // car
+    float confThreshold = 0.5f;
+    float nmsThreshold = 0.45f;
+    float lowRate = 0.1f;
+    std::string line; // empty = horizontal at 65% of the height
+    std::string zone; // empty = left half, 55% - 80% of the height
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--labels") {
+            opts.labelsDir = value;
+        } else if (arg == "--stem") {
+            opts.stem = value;
+        } else if (arg == "--repeat") {
+            opts.repeat = std::max(1, std::atoi(value));
+        } else if (arg == "--size") {
+            if (std::sscanf(value, "%dx%d", &opts.width, &opts.height) != 2)
+                return false;
+        } else if (arg == "--candidates") {
+            opts.candidatesPerLabel = std::max(1, std::atoi(value));
+        } else if (arg == "--class") {
+            opts.classId = std::atoi(value);
+        } else if (arg == "--line") {
+            opts.line = value;
+        } else if (arg == "--zone") {
+            opts.zone = value;
+        } else if (arg == "--low-rate") {
+            opts.lowRate = std::min(1.f, std::max(0.f, (float)std::atof(value)));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: bench_label_replay [--labels DIR] [--stem NAME] [--repeat N]"
+                     " [--size WxH] [--candidates N] [--class ID] [--line x1,y1,x2,y2]"
+                     " [--zone x1,y1,x2,y2,x3,y3,...] [--low-rate R]\n";
+        return 1;
+    }
+
+    CountingLine line;
+    if (opts.line.empty()) {
+        const float y = 0.65f * opts.height;
+        line.a = cv::Point2f(0.f, y);
+        line.b = cv::Point2f((float)opts.width, y);
+    } else if (!ParseCountingLine(opts.line, line)) {
+        std::cerr << "Bad counting line: " << opts.line << "\n";
+        return 1;
+    }
+    line.classId = opts.classId;
+
+    CountingZone zone;
+    if (opts.zone.empty()) {
+        const int y0 = (int)(0.55f * opts.height), y1 = (int)(0.8f * opts.height), x1 = opts.width / 2;
+        zone.polygon = { { 0, y0 }, { x1, y0 }, { x1, y1 }, { 0, y1 } };
+    } else if (!ParseCountingZone(opts.zone, zone)) {
+        std::cerr << "Bad counting zone: " << opts.zone << "\n";
+        return 1;
+    }
+    zone.classId = opts.classId;
+
+    LabelSequence labels;
+    if (!LoadLabelSequenceFromDefaultPaths(opts.labelsDir, opts.stem, labels)) {
+        std::cerr << "No label files found in " << opts.labelsDir << "\n";
+        return 1;
+    }
+
+    std::vector<CandidateFrame> candidates(labels.size());
+    cv::RNG rng(0x5eed);
+    size_t totalLabels = 0, totalCandidates = 0;
+    for (size_t f = 0; f < labels.size(); ++f) {
+        SynthesizeCandidates(labels[f], opts.width, opts.height, opts.candidatesPerLabel, rng, candidates[f],
+                             opts.lowRate);
+        totalLabels += labels[f].size();
+        totalCandidates += candidates[f].boxes.size();
+    }
+
+    std::cout << "Loaded " << labels.size() << " frames, " << totalLabels << " labels, "
+              << totalCandidates << " candidates (" << opts.candidatesPerLabel << " per label)\n";
+
+    Nms nms;
+    ByteTracker tracker;
+    LineCounter lineCounter({ line });
+    ZoneCounter zoneCounter({ zone });
+    zoneCounter.Prepare(cv::Size(opts.width, opts.height));
+    std::vector<int> indices, counting;
+    const float trackThreshold = tracker.GetConfig().lowScore;
+    LatencyStats frameStats(labels.size() * opts.repeat);
+    LatencyStats trackStats(labels.size() * opts.repeat);
+    LatencyStats zoneStats(labels.size() * opts.repeat);
+    uint64_t allocations = 0;
+    uint64_t kept = 0;
+    uint64_t counted = 0;
+    uint64_t occupied = 0;
+    uint64_t inZone = 0;
+
+    const auto runStart = BenchClock::now();
+    for (int r = 0; r < opts.repeat; ++r) {
+        tracker.Reset();
+        lineCounter.Reset();
+        for (const CandidateFrame& frame : candidates) {
+            const uint64_t allocsBefore = AllocationCount();
+            const auto start = BenchClock::now();
+
+            nms.Run(frame.boxes, frame.scores, frame.classIds, trackThreshold, opts.nmsThreshold, indices);
+            counting.clear();
+            for (int idx : indices) {
+                if (frame.scores[idx] > opts.confThreshold)
+                    counting.push_back(idx);
+            }
+            const auto zoneStart = BenchClock::now();
+            zoneCounter.Count(frame.boxes, frame.classIds, counting);
+            zoneStats.Add(MsSince(zoneStart));
+            int count = 0;
+            for (int idx : counting) {
+                if (frame.classIds[idx] == opts.classId)
+                    ++count;
+            }
+            const auto trackStart = BenchClock::now();
+            tracker.Update(frame.boxes, frame.scores, frame.classIds, indices);
+            const int occupancy = tracker.Occupancy(opts.classId);
+            lineCounter.Update(tracker);
+            trackStats.Add(MsSince(trackStart));
+
+            frameStats.Add(MsSince(start));
+            // The first pass grows scratch and track storage
+            if (r > 0)
+                allocations += AllocationCount() - allocsBefore;
+            kept += indices.size();
+            counted += count;
+            occupied += occupancy;
+            inZone += zoneCounter.Occupancy(0);
+        }
+    }
+    const double elapsedMs = MsSince(runStart);
+    const double frames = (double)frameStats.Count();
+    const double steadyFrames = (double)candidates.size() * std::max(1, opts.repeat - 1);
+
+    // Reference zone counts: point-in-polygon on every kept box
+    LatencyStats polygonStats(candidates.size());
+    uint64_t inPolygon = 0;
+    int zoneMismatches = 0;
+    for (const CandidateFrame& frame : candidates) {
+        nms.Run(frame.boxes, frame.scores, frame.classIds, opts.confThreshold, opts.nmsThreshold, indices);
+        zoneCounter.Count(frame.boxes, frame.classIds, indices);
+        const auto start = BenchClock::now();
+        int count = 0;
+        for (int idx : indices) {
+            const cv::Rect& b = frame.boxes[idx];
+            const cv::Point2f anchor((float)(b.x + b.width / 2), (float)(b.y + b.height - 1));
+            if (frame.classIds[idx] == opts.classId && cv::pointPolygonTest(zone.polygon, anchor, false) >= 0)
+                ++count;
+        }
+        polygonStats.Add(MsSince(start));
+        inPolygon += count;
+        if (count != zoneCounter.Occupancy(0))
+            ++zoneMismatches;
+    }
+
+    // Reference: the labels as perfect detections
+    ByteTracker refTracker;
+    LineCounter refLines({ line });
+    CandidateFrame clean;
+    for (const std::vector<LabelBox>& frame : labels) {
+        clean.Clear();
+        indices.clear();
+        for (const LabelBox& label : frame) {
+            indices.push_back((int)clean.boxes.size());
+            clean.boxes.push_back(LabelToRect(label, opts.width, opts.height));
+            clean.scores.push_back(label.confidence);
+            clean.classIds.push_back(label.classId);
+        }
+        refTracker.Update(clean.boxes, clean.scores, clean.classIds, indices);
+        refLines.Update(refTracker);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Replayed " << frameStats.Count() << " frames in " << elapsedMs << " ms\n"
+              << "  throughput   " << frames * 1000.0 / elapsedMs << " frames/s\n"
+              << "  latency      p50 " << frameStats.Percentile(50) * 1000.0 << " us  p99 "
+              << frameStats.Percentile(99) * 1000.0 << " us\n"
+              << "  tracker      p50 " << trackStats.Percentile(50) * 1000.0 << " us  p99 "
+              << trackStats.Percentile(99) * 1000.0 << " us  ("
+              << frames * 1000.0 / std::max(1e-9, trackStats.Total()) << " frames/s alone)\n"
+              << "  allocations  " << (opts.repeat > 1 ? allocations / steadyFrames : 0.0)
+              << " per frame after the first pass\n"
+              << "  after NMS    " << kept / frames << " boxes, " << counted / frames
+              << " of class " << opts.classId << " per frame\n"
+              << "  tracked      " << occupied / frames << " present per frame, "
+              << tracker.UniqueCount(opts.classId) << " unique of class " << opts.classId
+              << " (" << tracker.UniqueCount() << " all classes), low-score pass matched "
+              << tracker.LowScoreMatches() / (double)candidates.size() << " per frame\n"
+              << "  line         (" << line.a.x << "," << line.a.y << ")-(" << line.b.x << "," << line.b.y
+              << ") in " << lineCounter.In(0) << " out " << lineCounter.Out(0) << ", clean labels in "
+              << refLines.In(0) << " out " << refLines.Out(0)
+              << (lineCounter.In(0) == refLines.In(0) && lineCounter.Out(0) == refLines.Out(0) ? " (match)\n"
+                                                                                                : " (MISMATCH)\n")
+              << "  zone         " << inZone / frames << " per frame, lookup p50 "
+              << zoneStats.Percentile(50) * 1000.0 << " us; point-in-polygon "
+              << inPolygon / (double)candidates.size() << " per frame, p50 "
+              << polygonStats.Percentile(50) * 1000.0 << " us, " << zoneMismatches << " / "
+              << candidates.size() << " frames differ\n";
+    return 0;
+}
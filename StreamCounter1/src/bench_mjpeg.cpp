@@ -0,0 +1,198 @@
+#include "bench_stats.hpp"
+#include "letterbox.hpp"
+#include "mjpeg_decoder.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// MJPEG ingest: full decode then letterbox, against MjpegDecoder's
+// DCT-domain scaled decodes, down to the network input.
+//
+//   bench_mjpeg [image...] [--size WxH] [--input-size N] [--quality Q] [--frames N]
+//
+// The sample images (default image.jpg, image.png, image_rotated.jpg,
+// image_detected.png) are resized to the stream --size and JPEG-encoded at
+// --quality, standing in for a camera's MJPEG frames. Each path decodes them
+// in turn and letterboxes into the input planes as CountObjects() does;
+// "diff" is the mean absolute difference of those planes from the full
+// decode's, in 8-bit levels. "<" marks the scale ScaleFor() picks; sizes
+// marked * are below the letterbox resolution and get upsampled again.
+// "imdecode 1/N" is OpenCV's reduced decode at that scale, with a fresh Mat
+// per frame; "auto + preview" adds DecodeFull() for a displayed frame.
+
+namespace {
+
+struct Options {
+    std::vector<std::string> images;
+    int width = 1920;
+    int height = 1080;
+    int inputSize = 640;
+    int quality = 85;
+    int frames = 200;
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.empty() || arg[0] != '-') {
+            opts.images.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--size") {
+            if (std::sscanf(value, "%dx%d", &opts.width, &opts.height) != 2)
+                return false;
+        } else if (arg == "--input-size") {
+            opts.inputSize = std::max(32, std::atoi(value));
+        } else if (arg == "--quality") {
+            opts.quality = std::min(100, std::max(1, std::atoi(value)));
+        } else if (arg == "--frames") {
+            opts.frames = std::max(1, std::atoi(value));
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    if (opts.images.empty())
+        opts.images = { "image.jpg", "image.png", "image_rotated.jpg", "image_detected.png" };
+    return true;
+}
+
+struct Result {
+    cv::Size decoded;
+    LatencyStats decode, total;
+    double diff = 0.0;
+};
+
+// Runs decode(jpeg) -> BGR over every frame, letterboxing each into planes;
+// reference (if not empty) holds the full decode's planes per encoded image.
+template <class Decode>
+Result Run(const std::vector<std::vector<uint8_t>>& jpegs, const Options& opts,
+           const std::vector<std::vector<float>>& reference, std::vector<std::vector<float>>* keep,
+           Decode decode) {
+    Result result;
+    const size_t planeSize = 3 * (size_t)opts.inputSize * opts.inputSize;
+    std::vector<float> planes(planeSize);
+    cv::Mat resized, converted;
+    double diffSum = 0.0;
+    for (int n = 0; n < opts.frames; ++n) {
+        const size_t k = n % jpegs.size();
+        const auto start = BenchClock::now();
+        const cv::Mat& bgr = decode(jpegs[k]);
+        result.decode.Add(MsSince(start));
+        const LetterboxGeometry g = ComputeLetterbox(bgr.cols, bgr.rows, opts.inputSize, opts.inputSize);
+        LetterboxBgrInto(bgr, g, planes.data(), resized, converted);
+        result.total.Add(MsSince(start));
+        result.decoded = bgr.size();
+
+        if (keep && n < (int)jpegs.size())
+            keep->push_back(planes);
+        if (!reference.empty()) {
+            double sum = 0.0;
+            for (size_t i = 0; i < planeSize; ++i)
+                sum += std::fabs(planes[i] - reference[k][i]);
+            diffSum += sum * 255.0 / planeSize;
+        }
+    }
+    result.diff = diffSum / opts.frames;
+    return result;
+}
+
+void PrintRow(const std::string& name, const Result& r, bool upsampled, bool showDiff) {
+    std::ostringstream size;
+    size << r.decoded.width << "x" << r.decoded.height << (upsampled ? "*" : "");
+    std::cout << std::left << std::setw(16) << name << std::setw(11) << size.str() << std::right
+              << std::setw(9) << r.decode.Mean() << std::setw(9) << r.total.Mean() << std::setw(9)
+              << r.total.Percentile(99) << std::setw(9) << 1000.0 / r.total.Mean();
+    if (showDiff)
+        std::cout << std::setw(8) << r.diff;
+    else
+        std::cout << std::setw(8) << "-";
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: bench_mjpeg [image...] [--size WxH] [--input-size N] [--quality Q] [--frames N]\n";
+        return 1;
+    }
+
+    std::vector<std::vector<uint8_t>> jpegs;
+    size_t bytes = 0;
+    for (const std::string& path : opts.images) {
+        cv::Mat image = cv::imread(path);
+        if (image.empty()) {
+            std::cerr << "Skipping unreadable " << path << "\n";
+            continue;
+        }
+        cv::resize(image, image, cv::Size(opts.width, opts.height), 0, 0, cv::INTER_AREA);
+        jpegs.emplace_back();
+        cv::imencode(".jpg", image, jpegs.back(), { cv::IMWRITE_JPEG_QUALITY, opts.quality });
+        bytes += jpegs.back().size();
+    }
+    if (jpegs.empty()) {
+        std::cerr << "No sample images\n";
+        return 1;
+    }
+
+    const cv::Size stream(opts.width, opts.height), input(opts.inputSize, opts.inputSize);
+    const int autoDenom = MjpegDecoder::ScaleFor(stream, input);
+    const LetterboxGeometry full = ComputeLetterbox(opts.width, opts.height, opts.inputSize, opts.inputSize);
+    std::cout << jpegs.size() << " frames " << opts.width << "x" << opts.height << " q" << opts.quality << ", "
+              << bytes / jpegs.size() / 1024 << " KiB mean; input " << opts.inputSize << " (letterbox "
+              << full.innerWidth << "x" << full.innerHeight << "), ScaleFor 1/" << autoDenom << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "path            decoded     dec ms   tot ms      p99      fps    diff\n";
+
+    std::vector<std::vector<float>> reference;
+    cv::Mat decoded;
+    const Result baseline = Run(jpegs, opts, {}, &reference, [&](const std::vector<uint8_t>& jpeg) -> const cv::Mat& {
+        decoded = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+        return decoded;
+    });
+    PrintRow("imdecode", baseline, false, false);
+
+    MjpegDecoder decoder;
+    for (int denom = 1; denom <= 8; denom *= 2) {
+        const Result r = Run(jpegs, opts, reference, nullptr, [&](const std::vector<uint8_t>& jpeg) -> const cv::Mat& {
+            decoder.Decode(jpeg.data(), jpeg.size(), denom);
+            return decoder.Scaled();
+        });
+        const bool upsampled = r.decoded.width < full.innerWidth || r.decoded.height < full.innerHeight;
+        PrintRow("decoder 1/" + std::to_string(denom) + (denom == autoDenom ? " <" : ""), r, upsampled, true);
+    }
+
+    const int reduced = autoDenom == 8 ? cv::IMREAD_REDUCED_COLOR_8
+                      : autoDenom == 4 ? cv::IMREAD_REDUCED_COLOR_4
+                      : autoDenom == 2 ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_COLOR;
+    const Result r = Run(jpegs, opts, reference, nullptr, [&](const std::vector<uint8_t>& jpeg) -> const cv::Mat& {
+        decoded = cv::imdecode(jpeg, reduced);
+        return decoded;
+    });
+    PrintRow("imdecode 1/" + std::to_string(autoDenom), r, false, true);
+
+    // A preview frame costs a full decode on top of the scaled one
+    const Result preview = Run(jpegs, opts, {}, nullptr, [&](const std::vector<uint8_t>& jpeg) -> const cv::Mat& {
+        decoder.DecodeForInput(jpeg.data(), jpeg.size(), input);
+        decoder.DecodeFull(jpeg.data(), jpeg.size());
+        return decoder.Scaled();
+    });
+    PrintRow("auto + preview", preview, false, false);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "bench_stats.hpp"
+#include "label_replay.hpp"
+#include "nms.hpp"
+
+#include <opencv2/dnn.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// Nms against cv::dnn::NMSBoxes / NMSBoxesBatched across candidate counts.
+//
+//   bench_nms [iterations] [counts...]        (default 16 64 256 1024 4096)
+//
+// Each frame scatters count / 8 objects over 1920x1080 (3 classes, 10-150
+// px) and expands them into 8 jittered candidates each, as a YOLO head fires
+// neighbouring anchors. "same" is the share of frames where Nms kept exactly
+// the boxes OpenCV kept, in the same order.
+
+namespace {
+
+constexpr int kFrames = 16;
+constexpr int kPerLabel = 8;
+constexpr float kScoreThreshold = 0.25f;
+constexpr float kIouThreshold = 0.45f;
+constexpr int kTopK = 300;
+
+void MakeFrames(int count, std::vector<CandidateFrame>& frames) {
+    cv::RNG rng(0x5eed + count);
+    frames.assign(kFrames, CandidateFrame());
+    for (CandidateFrame& frame : frames) {
+        std::vector<LabelBox> labels(std::max(1, count / kPerLabel));
+        for (LabelBox& label : labels) {
+            label.classId = rng.uniform(0, 3);
+            label.w = (float)rng.uniform(10.0, 150.0) / 1920.f;
+            label.h = (float)rng.uniform(10.0, 150.0) / 1080.f;
+            label.cx = (float)rng.uniform(0.0, 1.0);
+            label.cy = (float)rng.uniform(0.0, 1.0);
+        }
+        SynthesizeCandidates(labels, 1920, 1080, kPerLabel, rng, frame);
+    }
+}
+
+template <typename Fn>
+double MicrosPerCall(int iterations, Fn&& fn) {
+    for (int i = 0; i < kFrames; ++i)
+        fn(i); // warm-up, grows scratch
+    const auto start = BenchClock::now();
+    for (int it = 0; it < iterations; ++it) {
+        for (int i = 0; i < kFrames; ++i)
+            fn(i);
+    }
+    return MsSince(start) * 1000.0 / ((double)iterations * kFrames);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    std::vector<int> counts;
+    for (int i = 2; i < argc; ++i)
+        counts.push_back(std::max(1, std::atoi(argv[i])));
+    if (counts.empty())
+        counts = { 16, 64, 256, 1024, 4096 };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "NMS, conf " << kScoreThreshold << ", IoU " << kIouThreshold << ", " << iterations
+              << " x " << kFrames << " frames per count (us per call)\n";
+    std::cout << "  candidates   NMSBoxes       Nms   same   Batched  Nms/class   same  Nms top-" << kTopK
+              << "\n";
+
+    std::vector<CandidateFrame> frames;
+    std::vector<int> ref, out;
+    Nms nms, nmsTopK(kTopK);
+    for (int count : counts) {
+        MakeFrames(count, frames);
+
+        int same = 0, sameBatched = 0;
+        for (const CandidateFrame& f : frames) {
+            cv::dnn::NMSBoxes(f.boxes, f.scores, kScoreThreshold, kIouThreshold, ref);
+            nms.Run(f.boxes, f.scores, kScoreThreshold, kIouThreshold, out);
+            same += ref == out;
+            cv::dnn::NMSBoxesBatched(f.boxes, f.scores, f.classIds, kScoreThreshold, kIouThreshold, ref);
+            nms.Run(f.boxes, f.scores, f.classIds, kScoreThreshold, kIouThreshold, out);
+            sameBatched += ref == out;
+        }
+
+        const double cvUs = MicrosPerCall(iterations, [&](int i) {
+            cv::dnn::NMSBoxes(frames[i].boxes, frames[i].scores, kScoreThreshold, kIouThreshold, ref);
+        });
+        const double nmsUs = MicrosPerCall(iterations, [&](int i) {
+            nms.Run(frames[i].boxes, frames[i].scores, kScoreThreshold, kIouThreshold, out);
+        });
+        const double cvBatchedUs = MicrosPerCall(iterations, [&](int i) {
+            cv::dnn::NMSBoxesBatched(frames[i].boxes, frames[i].scores, frames[i].classIds,
+                                     kScoreThreshold, kIouThreshold, ref);
+        });
+        const double nmsClassUs = MicrosPerCall(iterations, [&](int i) {
+            nms.Run(frames[i].boxes, frames[i].scores, frames[i].classIds, kScoreThreshold,
+                    kIouThreshold, out);
+        });
+        const double topKUs = MicrosPerCall(iterations, [&](int i) {
+            nmsTopK.Run(frames[i].boxes, frames[i].scores, frames[i].classIds, kScoreThreshold,
+                        kIouThreshold, out);
+        });
+
+        std::cout << "  " << std::setw(10) << frames[0].boxes.size() << std::setw(11) << cvUs
+                  << std::setw(10) << nmsUs << std::setw(6) << same * 100 / kFrames << "%"
+                  << std::setw(10) << cvBatchedUs << std::setw(11) << nmsClassUs << std::setw(6)
+                  << sameBatched * 100 / kFrames << "%" << std::setw(12) << topKUs << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "bench_stats.hpp"
+#include "nv12_preprocess.hpp"
+
+#include <opencv2/dnn.hpp>
+#include <opencv2/imgproc.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+// Compares the FishCounter preprocessing path
+//   cvtColor(COLOR_YUV2BGR_NV12) + blobFromImage(1/255, swapRB)
+// with the fused Nv12Preprocessor at 720p and 1080p.
+//
+//   bench_preprocess [iterations] [input-size]
+
+namespace {
+
+cv::Mat MakeSyntheticNV12(int width, int height) {
+    cv::Mat nv12(height + height / 2, width, CV_8UC1);
+    cv::RNG rng(12345);
+    cv::Mat yPlane = nv12.rowRange(0, height);
+    cv::Mat uvPlane = nv12.rowRange(height, nv12.rows);
+    for (int y = 0; y < height; ++y) {
+        uint8_t* row = yPlane.ptr<uint8_t>(y);
+        for (int x = 0; x < width; ++x)
+            row[x] = cv::saturate_cast<uint8_t>(16 + (x + y) % 220 + rng.uniform(-8, 8));
+    }
+    rng.fill(uvPlane, cv::RNG::UNIFORM, 64, 192);
+    return nv12;
+}
+
+// Letterboxed version of the two-call path, used only to check the fused output.
+cv::Mat ReferenceLetterboxBlob(const cv::Mat& nv12, const LetterboxGeometry& g) {
+    cv::Mat bgr, resized, padded;
+    cv::cvtColor(nv12, bgr, cv::COLOR_YUV2BGR_NV12);
+    cv::resize(bgr, resized, cv::Size(g.innerWidth, g.innerHeight), 0, 0, cv::INTER_LINEAR);
+    cv::copyMakeBorder(resized, padded, g.padY, g.dstHeight - g.innerHeight - g.padY,
+                       g.padX, g.dstWidth - g.innerWidth - g.padX,
+                       cv::BORDER_CONSTANT, cv::Scalar::all(114));
+    return cv::dnn::blobFromImage(padded, 1.0 / 255.0, cv::Size(), cv::Scalar(), true, false);
+}
+
+void Report(const char* name, const LatencyStats& stats) {
+    std::cout << "  " << std::left << std::setw(24) << name << std::right
+              << " mean " << std::setw(7) << stats.Mean()
+              << "  p50 " << std::setw(7) << stats.Percentile(50)
+              << "  p99 " << std::setw(7) << stats.Percentile(99) << " ms\n";
+}
+
+void RunCase(int width, int height, int inputSize, int iterations) {
+    cv::Mat nv12 = MakeSyntheticNV12(width, height);
+    LatencyStats baseline(iterations), fused(iterations);
+
+    cv::Mat bgr, blob;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = BenchClock::now();
+        cv::cvtColor(nv12, bgr, cv::COLOR_YUV2BGR_NV12);
+        blob = cv::dnn::blobFromImage(bgr, 1.0 / 255.0, cv::Size(inputSize, inputSize),
+                                      cv::Scalar(0, 0, 0), true, false);
+        baseline.Add(MsSince(start));
+    }
+
+    Nv12Preprocessor pre;
+    pre.Configure(width, height, inputSize, inputSize);
+    for (int i = 0; i < iterations; ++i) {
+        auto start = BenchClock::now();
+        pre.Configure(width, height, inputSize, inputSize);
+        pre.Run(nv12.data, width);
+        fused.Add(MsSince(start));
+    }
+
+    cv::Mat reference = ReferenceLetterboxBlob(nv12, pre.Geometry());
+    double maxDiff = cv::norm(reference, pre.Blob(), cv::NORM_INF);
+
+    std::cout << width << "x" << height << " -> " << inputSize << "x" << inputSize << "\n";
+    Report("cvtColor+blobFromImage", baseline);
+    Report("fused NV12 letterbox", fused);
+    std::cout << "  speedup " << baseline.Mean() / fused.Mean()
+              << "x  max |diff| vs letterboxed reference " << maxDiff << "\n\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200;
+    int inputSize = argc > 2 ? std::atoi(argv[2]) : 640;
+
+    std::cout << std::fixed << std::setprecision(3);
+    RunCase(1280, 720, inputSize, iterations);
+    RunCase(1920, 1080, inputSize, iterations);
+    return 0;
+}
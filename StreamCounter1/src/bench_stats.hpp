@@ -0,0 +1,46 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+using BenchClock = std::chrono::steady_clock;
+
+inline double MsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+// Collects per-frame latency samples (ms) and reports mean / percentiles.
+class LatencyStats {
+public:
+    explicit LatencyStats(size_t reserve = 4096) { samples_.reserve(reserve); }
+
+    void Add(double ms) {
+        samples_.push_back(ms);
+        total_ += ms;
+    }
+
+    void Clear() {
+        samples_.clear();
+        total_ = 0.0;
+    }
+
+    size_t Count() const { return samples_.size(); }
+    double Total() const { return total_; }
+    double Mean() const { return samples_.empty() ? 0.0 : total_ / samples_.size(); }
+
+    // p in [0, 100]. Sorts a copy, so call it at report time only.
+    double Percentile(double p) const {
+        if (samples_.empty())
+            return 0.0;
+        std::vector<double> sorted(samples_);
+        size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+        std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.end());
+        return sorted[idx];
+    }
+
+private:
+    std::vector<double> samples_;
+    double total_ = 0.0;
+};
@@ -0,0 +1,351 @@
+#include "byte_tracker.hpp"
+#include "yolo_detector.hpp"
+
+#include <algorithm>
+
+namespace {
+
+inline float IoU(float ax1, float ay1, float ax2, float ay2, float bx1, float by1, float bx2, float by2) {
+    const float iw = std::min(ax2, bx2) - std::max(ax1, bx1);
+    const float ih = std::min(ay2, by2) - std::max(ay1, by1);
+    if (iw <= 0.f || ih <= 0.f)
+        return 0.f;
+    const float inter = iw * ih;
+    return inter / ((ax2 - ax1) * (ay2 - ay1) + (bx2 - bx1) * (by2 - by1) - inter);
+}
+
+// Noise standard deviations relative to the box height, as in SORT /
+// ByteTrack: measurement and process noise on position, process noise on
+// velocity.
+constexpr float kStdPosition = 1.f / 20.f;
+constexpr float kStdVelocity = 1.f / 160.f;
+
+} // namespace
+
+void ByteTracker::Reset() {
+    frame_ = 0;
+    lowMatches_ = 0;
+    nextId_ = 1;
+    unique_.clear();
+    for (auto* v : { &id_, &cls_, &hits_, &lost_ })
+        v->clear();
+    for (auto* v : { &x1_, &y1_, &x2_, &y2_, &score_, &px_, &py_ })
+        v->clear();
+    flags_.clear();
+    kf_.clear();
+    now_ = 0;
+}
+
+void ByteTracker::AddDetection(const cv::Rect& box, float score, int classId) {
+    if (score < config_.lowScore)
+        return;
+    dx1_.push_back((float)box.x);
+    dy1_.push_back((float)box.y);
+    dx2_.push_back((float)(box.x + box.width));
+    dy2_.push_back((float)(box.y + box.height));
+    dScore_.push_back(score);
+    detCls_.push_back(classId);
+}
+
+void ByteTracker::Update(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                         const std::vector<int>& classIds, const std::vector<int>& keep, int64_t frame) {
+    for (auto* v : { &dx1_, &dy1_, &dx2_, &dy2_, &dScore_ })
+        v->clear();
+    detCls_.clear();
+    for (int idx : keep)
+        AddDetection(boxes[idx], scores[idx], classIds[idx]);
+    Associate(frame);
+}
+
+void ByteTracker::Update(const std::vector<Detection>& detections, int64_t frame) {
+    for (auto* v : { &dx1_, &dy1_, &dx2_, &dy2_, &dScore_ })
+        v->clear();
+    detCls_.clear();
+    for (const Detection& d : detections)
+        AddDetection(d.box, d.confidence, d.classId);
+    Associate(frame);
+}
+
+void ByteTracker::Predict() {
+    SavePrevCenters();
+    Advance();
+    ++now_;
+}
+
+void ByteTracker::SavePrevCenters() {
+    for (int t = 0; t < Size(); ++t) {
+        const cv::Point2f c = Center(t);
+        px_[t] = c.x;
+        py_[t] = c.y;
+    }
+}
+
+void ByteTracker::Advance() {
+    for (int t = 0; t < Size(); ++t) {
+        Kalman& k = kf_[t];
+        // A lost track coasts on its position only, as in ByteTrack; an
+        // extrapolated size would shrink or blow up the box
+        if (lost_[t] > 0)
+            k.v[2] = k.v[3] = 0.f;
+        const float h = std::max(1.f, k.x[3]);
+        const float qp = (kStdPosition * h) * (kStdPosition * h);
+        const float qv = (kStdVelocity * h) * (kStdVelocity * h);
+        for (int c = 0; c < 4; ++c) {
+            // x' = F x, P' = F P F^T + Q with F = [1 1; 0 1]
+            k.x[c] += k.v[c];
+            k.p00[c] += 2.f * k.p01[c] + k.p11[c] + qp;
+            k.p01[c] += k.p11[c];
+            k.p11[c] += qv;
+        }
+        k.x[2] = std::max(1.f, k.x[2]);
+        k.x[3] = std::max(1.f, k.x[3]);
+        SetBox(t);
+    }
+}
+
+void ByteTracker::SetCenter(int t, cv::Point2f c) {
+    kf_[t].x[0] = c.x;
+    kf_[t].x[1] = c.y;
+    SetBox(t);
+}
+
+void ByteTracker::SetBox(int t) {
+    const Kalman& k = kf_[t];
+    x1_[t] = k.x[0] - 0.5f * k.x[2];
+    y1_[t] = k.x[1] - 0.5f * k.x[3];
+    x2_[t] = k.x[0] + 0.5f * k.x[2];
+    y2_[t] = k.x[1] + 0.5f * k.x[3];
+}
+
+void ByteTracker::SetBoxAt(int t, int lag) {
+    const Kalman& k = kf_[t];
+    const float cx = k.x[0] - lag * k.v[0], cy = k.x[1] - lag * k.v[1];
+    const float w = std::max(1.f, k.x[2] - lag * k.v[2]), h = std::max(1.f, k.x[3] - lag * k.v[3]);
+    x1_[t] = cx - 0.5f * w;
+    y1_[t] = cy - 0.5f * h;
+    x2_[t] = cx + 0.5f * w;
+    y2_[t] = cy + 0.5f * h;
+}
+
+void ByteTracker::Associate(int64_t frame) {
+    ++frame_;
+    if (frame == kNextFrame)
+        frame = now_ + 1;
+    if (Size() == 0)
+        now_ = std::max(now_, frame);
+
+    // Match against where the tracks are expected to be on the detections'
+    // frame: advance them to it, or look back along their velocity if they
+    // were already predicted past it
+    SavePrevCenters();
+    for (; now_ < frame; ++now_)
+        Advance();
+    const int lag = (int)(now_ - frame);
+    if (lag > 0) {
+        for (int t = 0; t < Size(); ++t)
+            SetBoxAt(t, lag);
+    }
+
+    const int numTracks = (int)id_.size();
+    const int numDets = (int)dScore_.size();
+    trackMatch_.assign(numTracks, -1);
+    detMatch_.assign(numDets, -1);
+
+    // 1. Confirmed tracks (matched or lost) vs high-score detections
+    trackList_.clear();
+    for (int t = 0; t < numTracks; ++t) {
+        if (Confirmed(t))
+            trackList_.push_back(t);
+    }
+    detList_.clear();
+    for (int d = 0; d < numDets; ++d) {
+        if (dScore_[d] >= config_.highScore)
+            detList_.push_back(d);
+    }
+    Match(trackList_, detList_, config_.matchIou);
+
+    // 2. Confirmed tracks still unmatched and not already lost vs low-score
+    trackList_.clear();
+    for (int t = 0; t < numTracks; ++t) {
+        if (Confirmed(t) && lost_[t] == 0 && trackMatch_[t] < 0)
+            trackList_.push_back(t);
+    }
+    detList_.clear();
+    for (int d = 0; d < numDets; ++d) {
+        if (dScore_[d] < config_.highScore)
+            detList_.push_back(d);
+    }
+    Match(trackList_, detList_, config_.lowMatchIou);
+    for (int t : trackList_)
+        lowMatches_ += trackMatch_[t] >= 0;
+
+    // 3. Tentative tracks vs high-score detections nobody took
+    trackList_.clear();
+    for (int t = 0; t < numTracks; ++t) {
+        if (!Confirmed(t))
+            trackList_.push_back(t);
+    }
+    detList_.clear();
+    for (int d = 0; d < numDets; ++d) {
+        if (dScore_[d] >= config_.highScore && detMatch_[d] < 0)
+            detList_.push_back(d);
+    }
+    Match(trackList_, detList_, config_.tentativeIou);
+
+    for (int t = 0; t < numTracks; ++t) {
+        if (trackMatch_[t] >= 0) {
+            Assign(t, trackMatch_[t], lag);
+        } else {
+            ++lost_[t];
+            SetBox(t);
+        }
+    }
+    Compact();
+
+    // New tracks; on the very first frame they are confirmed at once, as in
+    // ByteTrack, so objects already in view are counted
+    for (int d = 0; d < numDets; ++d) {
+        if (detMatch_[d] >= 0 || dScore_[d] < config_.newTrackScore)
+            continue;
+        id_.push_back(nextId_++);
+        cls_.push_back(detCls_[d]);
+        hits_.push_back(frame_ == 1 ? config_.confirmHits : 1);
+        lost_.push_back(0);
+        x1_.push_back(dx1_[d]);
+        y1_.push_back(dy1_[d]);
+        x2_.push_back(dx2_[d]);
+        y2_.push_back(dy2_[d]);
+        score_.push_back(dScore_[d]);
+        px_.push_back(0.5f * (dx1_[d] + dx2_[d]));
+        py_.push_back(0.5f * (dy1_[d] + dy2_[d]));
+        flags_.push_back(0);
+
+        Kalman k;
+        k.x[0] = px_.back();
+        k.x[1] = py_.back();
+        k.x[2] = dx2_[d] - dx1_[d];
+        k.x[3] = dy2_[d] - dy1_[d];
+        const float h = std::max(1.f, k.x[3]);
+        for (int c = 0; c < 4; ++c) {
+            k.v[c] = 0.f;
+            k.p00[c] = (2.f * kStdPosition * h) * (2.f * kStdPosition * h);
+            k.p01[c] = 0.f;
+            k.p11[c] = (10.f * kStdVelocity * h) * (10.f * kStdVelocity * h);
+        }
+        kf_.push_back(k);
+        if (Confirmed((int)id_.size() - 1)) {
+            const int c = std::max(0, detCls_[d]);
+            if (c >= (int)unique_.size())
+                unique_.resize(c + 1, 0);
+            ++unique_[c];
+        }
+    }
+}
+
+void ByteTracker::Match(const std::vector<int>& tracks, const std::vector<int>& dets, float minIou) {
+    pairs_.clear();
+    for (int t : tracks) {
+        for (int d : dets) {
+            if (detMatch_[d] >= 0 || cls_[t] != detCls_[d])
+                continue;
+            const float iou = IoU(x1_[t], y1_[t], x2_[t], y2_[t], dx1_[d], dy1_[d], dx2_[d], dy2_[d]);
+            if (iou >= minIou)
+                pairs_.push_back({ iou, t, d });
+        }
+    }
+    std::sort(pairs_.begin(), pairs_.end(), [](const Pair& a, const Pair& b) {
+        if (a.iou != b.iou)
+            return a.iou > b.iou;
+        return a.track < b.track || (a.track == b.track && a.det < b.det);
+    });
+    for (const Pair& p : pairs_) {
+        if (trackMatch_[p.track] >= 0 || detMatch_[p.det] >= 0)
+            continue;
+        trackMatch_[p.track] = p.det;
+        detMatch_[p.det] = p.track;
+    }
+}
+
+void ByteTracker::Assign(int t, int d, int lag) {
+    const bool wasConfirmed = Confirmed(t);
+    Kalman& k = kf_[t];
+    const float z[4] = { 0.5f * (dx1_[d] + dx2_[d]), 0.5f * (dy1_[d] + dy2_[d]), dx2_[d] - dx1_[d],
+                         dy2_[d] - dy1_[d] };
+    const float h = std::max(1.f, k.x[3]);
+    const float r = (kStdPosition * h) * (kStdPosition * h);
+    for (int c = 0; c < 4; ++c) {
+        // The position lag frames ago is observed: H = [1 -lag] (H = [1 0]
+        // for a detection of the current frame), K = P H^T / (H P H^T + R)
+        const float hp0 = k.p00[c] - lag * k.p01[c];
+        const float hp1 = k.p01[c] - lag * k.p11[c];
+        const float s = hp0 - lag * hp1 + r;
+        const float k0 = hp0 / s;
+        const float k1 = hp1 / s;
+        const float y = z[c] - (k.x[c] - lag * k.v[c]);
+        k.x[c] += k0 * y;
+        k.v[c] += k1 * y;
+        k.p00[c] -= k0 * hp0;
+        k.p01[c] -= k0 * hp1;
+        k.p11[c] -= k1 * hp1;
+    }
+    SetBox(t);
+    score_[t] = dScore_[d];
+    lost_[t] = 0;
+    ++hits_[t];
+    if (!wasConfirmed && Confirmed(t)) {
+        const int c = std::max(0, cls_[t]);
+        if (c >= (int)unique_.size())
+            unique_.resize(c + 1, 0);
+        ++unique_[c];
+    }
+}
+
+void ByteTracker::Compact() {
+    // Tentative tracks die on their first miss, confirmed ones after maxLost
+    int out = 0;
+    const int n = (int)id_.size();
+    for (int t = 0; t < n; ++t) {
+        if (lost_[t] > (Confirmed(t) ? config_.maxLost : 0))
+            continue;
+        if (out != t) {
+            id_[out] = id_[t];
+            cls_[out] = cls_[t];
+            hits_[out] = hits_[t];
+            lost_[out] = lost_[t];
+            x1_[out] = x1_[t];
+            y1_[out] = y1_[t];
+            x2_[out] = x2_[t];
+            y2_[out] = y2_[t];
+            score_[out] = score_[t];
+            px_[out] = px_[t];
+            py_[out] = py_[t];
+            flags_[out] = flags_[t];
+            kf_[out] = kf_[t];
+        }
+        ++out;
+    }
+    for (auto* v : { &id_, &cls_, &hits_, &lost_ })
+        v->resize(out);
+    for (auto* v : { &x1_, &y1_, &x2_, &y2_, &score_, &px_, &py_ })
+        v->resize(out);
+    flags_.resize(out);
+    kf_.resize(out);
+}
+
+int ByteTracker::Occupancy(int classId) const {
+    int count = 0;
+    for (int t = 0; t < Size(); ++t) {
+        if (Confirmed(t) && lost_[t] <= config_.occupancyHold && (classId < 0 || cls_[t] == classId))
+            ++count;
+    }
+    return count;
+}
+
+int ByteTracker::UniqueCount(int classId) const {
+    if (classId >= 0)
+        return classId < (int)unique_.size() ? unique_[classId] : 0;
+    int total = 0;
+    for (int n : unique_)
+        total += n;
+    return total;
+}
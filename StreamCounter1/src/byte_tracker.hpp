@@ -0,0 +1,150 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+struct Detection;
+
+// ByteTrack-style multi-object tracker over post-NMS detections.
+//
+// Each Update() is one inferred frame. Confirmed tracks are matched first
+// to high-score detections, then tracks still unmatched to low-score ones
+// (which recovers briefly occluded objects without letting weak boxes start
+// tracks), then tentative tracks to what is left. Matching is greedy by
+// IoU, within a class. Tracks start tentative from a high-score detection
+// and are confirmed on their confirmHits-th match; an unmatched confirmed
+// track is kept as lost for maxLost updates before it is dropped.
+//
+// Every track carries a constant-velocity Kalman filter on its box centre
+// and size, one decoupled position / velocity pair per coordinate (2 x 2
+// covariance each, plain floats, no cv::KalmanFilter). The tracker keeps the
+// capture frame its filters are at: Predict() advances all tracks by one
+// frame, so with inference every N frames the boxes, and the line / zone
+// counters reading them, still move at camera rate. Update() takes the
+// frame its detections were captured on: tracks behind it are advanced to
+// it first; tracks already predicted past it (inference finishing after
+// later frames were captured) are matched where they were on that frame
+// and corrected with the delayed measurement, so they stay at the present.
+// Without a frame, detections belong to the frame after the current one.
+//
+// Counts: UniqueCount() is the number of tracks ever confirmed, i.e. objects
+// that passed through; Occupancy() is the confirmed tracks present now. For
+// the low-score pass to see anything, decode and NMS must keep boxes down to
+// lowScore (DetectorConfig::trackThreshold); highScore then plays the part
+// of the detector's confThreshold and should equal it.
+//
+// Track state is struct-of-arrays and all scratch keeps its capacity, so
+// steady-state updates do not allocate. Not thread-safe; one per stream.
+class ByteTracker {
+public:
+    struct Config {
+        float highScore = 0.5f;      // first pass; only these start tracks
+        float lowScore = 0.1f;       // second pass; below this, ignored
+        float newTrackScore = 0.5f;  // at most highScore, or high boxes below it are dropped
+        float matchIou = 0.2f;       // confirmed vs high
+        float lowMatchIou = 0.5f;    // confirmed vs low
+        float tentativeIou = 0.3f;   // tentative vs remaining high
+        int confirmHits = 2;
+        int maxLost = 30;            // updates
+        int occupancyHold = 0;       // updates a lost track still counts as present
+    };
+
+    static constexpr int64_t kNextFrame = -1;
+
+    ByteTracker() = default;
+    explicit ByteTracker(const Config& config) : config_(config) {}
+
+    // Post-NMS detections: boxes[i], scores[i], classIds[i] for i in keep
+    // (the NMS output indices). frame: capture frame index of the
+    // detections, on the same count as Predict(); kNextFrame = Frame() + 1.
+    void Update(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+                const std::vector<int>& classIds, const std::vector<int>& keep, int64_t frame = kNextFrame);
+    void Update(const std::vector<Detection>& detections, int64_t frame = kNextFrame);
+    // Advances every track one frame along its velocity.
+    void Predict();
+    void Reset();
+
+    // classId < 0 = all classes.
+    int Occupancy(int classId = -1) const;
+    int UniqueCount(int classId = -1) const;
+    uint64_t Updates() const { return frame_; }
+    // Detections matched by the low-score pass since Reset().
+    uint64_t LowScoreMatches() const { return lowMatches_; }
+    // Capture frame the tracks are at.
+    int64_t Frame() const { return now_; }
+
+    // Tracks, confirmed or not, in creation order. Valid until the next Update().
+    int Size() const { return (int)id_.size(); }
+    int Id(int i) const { return id_[i]; }
+    int ClassId(int i) const { return cls_[i]; }
+    float Score(int i) const { return score_[i]; }
+    cv::Rect2f Box(int i) const { return cv::Rect2f(x1_[i], y1_[i], x2_[i] - x1_[i], y2_[i] - y1_[i]); }
+    bool Confirmed(int i) const { return hits_[i] >= config_.confirmHits; }
+    // Matched in the last Update().
+    bool Matched(int i) const { return lost_[i] == 0; }
+    int Lost(int i) const { return lost_[i]; }
+
+    // Box centre now and before the last Update() or Predict(); equal if
+    // the track did not move.
+    cv::Point2f Center(int i) const { return cv::Point2f(0.5f * (x1_[i] + x2_[i]), 0.5f * (y1_[i] + y2_[i])); }
+    cv::Point2f PrevCenter(int i) const { return cv::Point2f(px_[i], py_[i]); }
+    // Moves a track's box (and filter position) to centre c, e.g. by optical
+    // flow after Predict().
+    void SetCenter(int i, cv::Point2f c);
+
+    // Per-track bits for consumers such as LineCounter; 0 for a new track.
+    uint32_t Flags(int i) const { return flags_[i]; }
+    void SetFlags(int i, uint32_t flags) { flags_[i] = flags; }
+
+    const Config& GetConfig() const { return config_; }
+
+private:
+    void AddDetection(const cv::Rect& box, float score, int classId);
+    void Associate(int64_t frame);
+    // Greedy IoU matching of tracks[] to dets[]; pairs below minIou or of
+    // different classes never match.
+    void Match(const std::vector<int>& tracks, const std::vector<int>& dets, float minIou);
+    // lag: frames the detection is older than the filter state.
+    void Assign(int track, int det, int lag);
+    void Compact();
+    void SetBox(int track);
+    // Box where the track was lag frames ago, by its velocity.
+    void SetBoxAt(int track, int lag);
+    void SavePrevCenters();
+    void Advance();
+
+    // Per track: cx, cy, w, h with their velocities (px per step) and the
+    // 2 x 2 covariance of each pair.
+    struct Kalman {
+        float x[4], v[4];
+        float p00[4], p01[4], p11[4];
+    };
+
+    Config config_;
+    uint64_t frame_ = 0;
+    uint64_t lowMatches_ = 0;
+    int nextId_ = 1;
+    std::vector<int> unique_; // per class id
+
+    // Tracks
+    std::vector<int> id_, cls_, hits_, lost_;
+    std::vector<float> x1_, y1_, x2_, y2_, score_;
+    std::vector<float> px_, py_;
+    std::vector<uint32_t> flags_;
+    std::vector<Kalman> kf_;
+    int64_t now_ = 0; // capture frame of the filter state
+
+    // Detections of the current update
+    std::vector<int> detCls_;
+    std::vector<float> dx1_, dy1_, dx2_, dy2_, dScore_;
+
+    // Scratch
+    struct Pair {
+        float iou;
+        int track, det;
+    };
+    std::vector<Pair> pairs_;
+    std::vector<int> trackMatch_, detMatch_; // -1 = free
+    std::vector<int> trackList_, detList_;
+};
@@ -0,0 +1,125 @@
+#include "bench_stats.hpp"
+#include "int8_calibration.hpp"
+#include "yolo_detector.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Builds the INT8 calibration set from our own footage and checks it.
+//
+//   calibrate_int8 [source...] [--out DIR] [--frames N] [--stride K]
+//                  [--model PATH] [--names PATH] [--input-size N|WxH]
+//
+// Sources are images (image.jpg) or videos (Video.mp4, sampled every K
+// frames). The selected frames are written to DIR (default AIStuff/calib),
+// where YoloDetector and FishCounter --int8 pick them up. The tool then
+// quantises the model once and reports how far INT8 counts drift from FP32
+// on the calibration frames themselves.
+
+namespace {
+
+struct Options {
+    std::vector<std::string> sources;
+    std::string outDir = "AIStuff/calib";
+    int maxFrames = 32;
+    int stride = 10;
+    DetectorConfig detector;
+};
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.empty() || arg[0] != '-') {
+            opts.sources.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--out") {
+            opts.outDir = value;
+        } else if (arg == "--frames") {
+            opts.maxFrames = std::max(1, std::atoi(value));
+        } else if (arg == "--stride") {
+            opts.stride = std::max(1, std::atoi(value));
+        } else if (arg == "--model") {
+            opts.detector.modelPath = value;
+        } else if (arg == "--names") {
+            opts.detector.classNamesPath = value;
+        } else if (arg == "--input-size") {
+            if (!ParseInputSize(value, opts.detector.inputSize))
+                return false;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    if (opts.sources.empty())
+        opts.sources = { "image.jpg", "image_rotated.jpg", "Video.mp4" };
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        std::cerr << "Usage: calibrate_int8 [source...] [--out DIR] [--frames N] [--stride K]"
+                     " [--model PATH] [--names PATH] [--input-size N|WxH]\n";
+        return 1;
+    }
+
+    std::vector<cv::Mat> frames;
+    if (!CollectCalibrationFrames(opts.sources, opts.maxFrames, opts.stride, frames)) {
+        std::cerr << "No calibration frames found\n";
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(opts.outDir, ec);
+    if (!SaveCalibrationFrames(opts.outDir, frames))
+        return 1;
+    std::cout << "Wrote " << frames.size() << " calibration frames to " << opts.outDir << "\n";
+
+    YoloDetector fp32, int8;
+    if (!LoadDetectorFromDefaultPaths(fp32, opts.detector)) {
+        std::cerr << "Cannot load YOLO model\n";
+        return 1;
+    }
+    // Same resolved model, no pre-quantised ONNX: quantise from the new set
+    DetectorConfig config = fp32.Config();
+    config.precision = ModelPrecision::INT8;
+    config.int8ModelPath.clear();
+    config.calibrationDir = opts.outDir;
+    if (!int8.Load(config) || int8.Precision() != ModelPrecision::INT8) {
+        std::cerr << "Quantisation failed\n";
+        return 1;
+    }
+
+    LatencyStats fp32Forward, int8Forward;
+    double countDiff = 0.0;
+    int agree = 0;
+    for (const cv::Mat& frame : frames) {
+        StageTimings t;
+        const int a = fp32.CountObjects(frame, &t);
+        fp32Forward.Add(t.forwardMs);
+        const int b = int8.CountObjects(frame, &t);
+        int8Forward.Add(t.forwardMs);
+        countDiff += std::abs(a - b);
+        agree += a == b;
+    }
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "  forward FP32 p50 " << fp32Forward.Percentile(50) << " ms  INT8 p50 "
+              << int8Forward.Percentile(50) << " ms\n"
+              << "  count   mean |INT8 - FP32| " << countDiff / frames.size() << "  identical on "
+              << agree << " / " << frames.size() << " frames\n";
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "flow_propagator.hpp"
+#include "byte_tracker.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+#include <algorithm>
+
+namespace {
+
+float Median(std::vector<float>& v) {
+    auto mid = v.begin() + v.size() / 2;
+    std::nth_element(v.begin(), mid, v.end());
+    return *mid;
+}
+
+} // namespace
+
+void FlowPropagator::Reset() {
+    seeded_ = false;
+    tracks_ = 0;
+    updates_ = 0;
+    prevPts_.clear();
+    start_.clear();
+}
+
+void FlowPropagator::Seed(const cv::Mat& grey, const ByteTracker& tracker) {
+    SeedBoxes(tracker);
+    SeedFeatures(grey);
+}
+
+bool FlowPropagator::NeedsSeed(const ByteTracker& tracker) const {
+    return !seeded_ || updates_ != tracker.Updates();
+}
+
+void FlowPropagator::SeedBoxes(const ByteTracker& tracker) {
+    tracks_ = tracker.Size();
+    updates_ = tracker.Updates();
+    seedBoxes_.assign(tracks_, cv::Rect());
+    for (int t = 0; t < tracks_; ++t) {
+        if (tracker.Lost(t) > 0)
+            continue;
+        const cv::Rect2f box = tracker.Box(t);
+        const float insetX = config_.inset * box.width, insetY = config_.inset * box.height;
+        seedBoxes_[t] = cv::Rect(cv::Rect2f(box.x + insetX, box.y + insetY, box.width - 2.f * insetX,
+                                            box.height - 2.f * insetY));
+    }
+    seeded_ = false;
+}
+
+void FlowPropagator::SeedFeatures(const cv::Mat& grey) {
+    // No reuse of the input as level 0: the caller's frame buffer may be
+    // gone by the next Propagate()
+    cv::buildOpticalFlowPyramid(grey, prevPyr_, config_.window, config_.levels, true, cv::BORDER_REFLECT_101,
+                                cv::BORDER_CONSTANT, false);
+
+    prevPts_.clear();
+    start_.resize(tracks_ + 1);
+    const cv::Rect frame(0, 0, grey.cols, grey.rows);
+    for (int t = 0; t < tracks_; ++t) {
+        start_[t] = (int)prevPts_.size();
+        const cv::Rect inner = seedBoxes_[t] & frame;
+        if (inner.width < 8 || inner.height < 8)
+            continue;
+        cv::goodFeaturesToTrack(grey(inner), corners_, config_.maxPoints, config_.quality, config_.minDistance);
+        for (const cv::Point2f& c : corners_)
+            prevPts_.emplace_back(c.x + inner.x, c.y + inner.y);
+    }
+    start_[tracks_] = (int)prevPts_.size();
+    seeded_ = true;
+}
+
+void FlowPropagator::Propagate(const cv::Mat& grey, ByteTracker& tracker) {
+    tracker.Predict();
+    if (NeedsSeed(tracker) || tracks_ != tracker.Size())
+        return;
+
+    cv::buildOpticalFlowPyramid(grey, nextPyr_, config_.window, config_.levels, true, cv::BORDER_REFLECT_101,
+                                cv::BORDER_CONSTANT, false);
+    if (!prevPts_.empty()) {
+        cv::calcOpticalFlowPyrLK(prevPyr_, nextPyr_, prevPts_, nextPts_, status_, err_, config_.window,
+                                 config_.levels);
+    }
+
+    // Median flow per track; survivors are compacted in place for the next frame
+    int out = 0;
+    for (int t = 0; t < tracks_; ++t) {
+        const int begin = start_[t], end = start_[t + 1];
+        start_[t] = out;
+        dx_.clear();
+        dy_.clear();
+        for (int i = begin; i < end; ++i) {
+            if (!status_[i])
+                continue;
+            dx_.push_back(nextPts_[i].x - prevPts_[i].x);
+            dy_.push_back(nextPts_[i].y - prevPts_[i].y);
+            prevPts_[out++] = nextPts_[i];
+        }
+        if ((int)dx_.size() >= config_.minPoints)
+            tracker.SetCenter(t, tracker.PrevCenter(t) + cv::Point2f(Median(dx_), Median(dy_)));
+    }
+    start_[tracks_] = out;
+    prevPts_.resize(out);
+    std::swap(prevPyr_, nextPyr_);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+class ByteTracker;
+
+// Moves tracked boxes on frames without inference by sparse optical flow.
+//
+// After each inference (keyframe), Seed() picks good features to track
+// inside every matched track's box on the grey image. On the frames in
+// between, Propagate() follows those points with pyramidal Lucas-Kanade and
+// shifts each box by the median displacement of its surviving points; boxes
+// with too few points left fall back to the tracker's Kalman prediction.
+// Every frame's pyramid is built once and kept as the next frame's previous
+// pyramid. Points refer to track indices, so every ByteTracker::Update()
+// needs a new seed (NeedsSeed()); until then Propagate() only predicts.
+//
+// The seed image must be the frame the boxes are at. When inference results
+// arrive late, Update() corrects the boxes to the present, so seed on the
+// next captured frame rather than the inferred one; SeedBoxes() then
+// SeedFeatures() split the seed so that only the box snapshot needs the
+// lock of a tracker shared between threads. Not thread-safe; one per stream.
+class FlowPropagator {
+public:
+    struct Config {
+        int maxPoints = 24;         // per box
+        double quality = 0.01;      // goodFeaturesToTrack
+        double minDistance = 4.0;   // px
+        float inset = 0.15f;        // box fraction trimmed per side, to stay off the background
+        cv::Size window{ 15, 15 };
+        int levels = 3;
+        int minPoints = 3;          // fewer left: Kalman prediction only
+    };
+
+    FlowPropagator() = default;
+    explicit FlowPropagator(const Config& config) : config_(config) {}
+
+    // Keyframe: grey (CV_8U) is the frame the tracker's boxes are at.
+    // SeedBoxes() then SeedFeatures().
+    void Seed(const cv::Mat& grey, const ByteTracker& tracker);
+    // Snapshots the matched tracks' boxes; cheap.
+    void SeedBoxes(const ByteTracker& tracker);
+    // Pyramid and goodFeaturesToTrack inside the snapshot boxes.
+    void SeedFeatures(const cv::Mat& grey);
+    // The tracker was updated (or never seeded) since the last SeedBoxes().
+    bool NeedsSeed(const ByteTracker& tracker) const;
+    // Frame without inference: Predict()s the tracker, then moves the boxes
+    // that still have points by their flow from the previous frame.
+    void Propagate(const cv::Mat& grey, ByteTracker& tracker);
+    void Reset();
+
+    bool Seeded() const { return seeded_; }
+    int Points() const { return (int)prevPts_.size(); }
+
+private:
+    Config config_;
+    bool seeded_ = false;
+    int tracks_ = 0;
+    uint64_t updates_ = 0; // tracker.Updates() at the seed
+    std::vector<cv::Rect> seedBoxes_; // inner box per track, empty = no points
+
+    std::vector<cv::Mat> prevPyr_, nextPyr_;
+    std::vector<cv::Point2f> prevPts_, nextPts_;
+    std::vector<int> start_; // track t owns points [start_[t], start_[t + 1])
+    std::vector<uchar> status_;
+    std::vector<float> err_;
+
+    // Scratch
+    std::vector<cv::Point2f> corners_;
+    std::vector<float> dx_, dy_;
+};
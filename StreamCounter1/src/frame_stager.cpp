@@ -0,0 +1,24 @@
+#include "frame_stager.hpp"
+
+BoxTransform FrameStager::StageNV12(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane,
+                                    int uvStride, int width, int height, float* planes) {
+    const cv::Rect roi = AlignNv12Roi(roi_, width, height);
+    OffsetNv12Planes(roi, yPlane, yStride, uvPlane, uvStride);
+    nv12_.Configure(roi.width, roi.height, inputSize_.width, inputSize_.height);
+    nv12_.RunInto(yPlane, yStride, uvPlane, uvStride, planes);
+    BoxTransform transform = nv12_.Transform();
+    transform.originX = (float)roi.x;
+    transform.originY = (float)roi.y;
+    return transform;
+}
+
+BoxTransform FrameStager::StageBGR(const cv::Mat& bgr, float* planes) {
+    const cv::Rect roi = AlignNv12Roi(roi_, bgr.cols, bgr.rows);
+    const cv::Mat crop = bgr(roi);
+    const LetterboxGeometry g = ComputeLetterbox(crop.cols, crop.rows, inputSize_.width, inputSize_.height);
+    LetterboxBgrInto(crop, g, planes, resized_, converted_);
+    BoxTransform transform = g.ToBoxTransform();
+    transform.originX = (float)roi.x;
+    transform.originY = (float)roi.y;
+    return transform;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "letterbox.hpp"
+#include "nv12_preprocess.hpp"
+#include "yolo_decoder.hpp"
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+
+// Per-stream preprocessing for the multi-stream front ends (InferenceBatcher,
+// InferencePool): crops the stream's counting zone out of an NV12 or BGR
+// frame and letterboxes it into caller-owned 3 x H x W planes, returning the
+// transform back to full-frame pixels. Keeps its scratch buffers between
+// frames; use one per stream.
+class FrameStager {
+public:
+    void Configure(const cv::Rect& roi, cv::Size inputSize) {
+        roi_ = roi;
+        inputSize_ = inputSize;
+    }
+    const cv::Rect& Roi() const { return roi_; }
+
+    BoxTransform StageNV12(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane, int uvStride,
+                           int width, int height, float* planes);
+    BoxTransform StageBGR(const cv::Mat& bgr, float* planes);
+
+private:
+    cv::Rect roi_;
+    cv::Size inputSize_;
+    Nv12Preprocessor nv12_;
+    cv::Mat resized_, converted_;
+};
@@ -0,0 +1,112 @@
+#include "inference_backend.hpp"
+#include "bench_stats.hpp"
+#include "letterbox.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef HAVE_ONNXRUNTIME
+std::unique_ptr<InferenceBackend> CreateOnnxRuntimeBackend();
+#endif
+
+double InferenceBackend::Warmup(int runs) {
+    float* input = InputBuffer(1);
+    std::fill(input, input + (size_t)3 * inputSize_.area(), kLetterboxPadValue);
+    double lastMs = 0.0;
+    for (int i = 0; i < runs; ++i) {
+        auto start = BenchClock::now();
+        Forward(1);
+        lastMs = MsSince(start);
+    }
+    return lastMs;
+}
+
+bool OpenCvBackend::Load(const std::string& modelPath, cv::Size inputSize) {
+    if (threads_ > 0)
+        cv::setNumThreads(threads_);
+    try {
+        cv::dnn::Net net = cv::dnn::readNetFromONNX(modelPath);
+        if (net.empty()) {
+            std::cerr << "[YOLO] Failed to load model\n";
+            return false;
+        }
+        net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        net_ = net;
+        outNames_ = net_.getUnconnectedOutLayersNames();
+    } catch (const std::exception& e) {
+        std::cerr << "[YOLO] Exception: " << e.what() << "\n";
+        return false;
+    }
+    inputSize_ = inputSize;
+    input_.release();
+    inputHeaders_.clear();
+    outputs_.clear();
+    return true;
+}
+
+float* OpenCvBackend::InputBuffer(int batch) {
+    if (input_.empty() || input_.size[0] < batch) {
+        const int shape[] = { batch, 3, inputSize_.height, inputSize_.width };
+        input_.create(4, shape, CV_32F);
+        inputHeaders_.clear();
+    }
+    return input_.ptr<float>();
+}
+
+void OpenCvBackend::Forward(int batch) {
+    // 4-d headers allocate their size/step arrays, so keep one per batch size
+    InputBuffer(batch);
+    if ((int)inputHeaders_.size() <= batch)
+        inputHeaders_.resize(batch + 1);
+    cv::Mat& header = inputHeaders_[batch];
+    if (header.empty()) {
+        const int shape[] = { batch, 3, inputSize_.height, inputSize_.width };
+        header = cv::Mat(4, shape, CV_32F, input_.ptr<float>());
+    }
+    net_.setInput(header);
+    net_.forward(outputs_, outNames_);
+}
+
+TensorView OpenCvBackend::Output(int index) const {
+    TensorView view;
+    if (index >= (int)outputs_.size())
+        return view;
+    const cv::Mat& out = outputs_[index];
+    view.data = out.ptr<float>();
+    view.dims = std::min(out.dims, 4);
+    for (int d = 0; d < view.dims; ++d)
+        view.shape[d] = out.size[d];
+    return view;
+}
+
+bool ParseBackendKind(const std::string& text, BackendKind& kind) {
+    if (text == "opencv") {
+        kind = BackendKind::OpenCV;
+        return true;
+    }
+    if (text == "ort" || text == "onnxruntime") {
+        kind = BackendKind::OnnxRuntime;
+        return true;
+    }
+    return false;
+}
+
+const char* BackendKindName(BackendKind kind) {
+    return kind == BackendKind::OnnxRuntime ? "onnxruntime" : "opencv";
+}
+
+std::unique_ptr<InferenceBackend> CreateInferenceBackend(BackendKind kind) {
+    switch (kind) {
+    case BackendKind::OpenCV:
+        return std::make_unique<OpenCvBackend>();
+    case BackendKind::OnnxRuntime:
+#ifdef HAVE_ONNXRUNTIME
+        return CreateOnnxRuntimeBackend();
+#else
+        std::cerr << "[YOLO] Built without ONNX Runtime (HAVE_ONNXRUNTIME)\n";
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
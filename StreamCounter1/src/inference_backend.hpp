@@ -0,0 +1,108 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Read-only view of an output tensor owned by the backend. Valid until the
+// next Forward() or Load().
+struct TensorView {
+    const float* data = nullptr;
+    int dims = 0;
+    int shape[4] = { 0, 0, 0, 0 };
+
+    // Header over data, e.g. for YoloV8Decoder::Decode; no copy.
+    cv::Mat AsMat() const { return cv::Mat(dims, shape, CV_32F, const_cast<float*>(data)); }
+};
+
+// Model load, input binding, forward and output views for one network.
+//
+// The backend owns a preallocated N x 3 x H x W float input buffer that
+// callers fill in place (Nv12Preprocessor::RunInto, LetterboxBgrInto), and
+// output buffers that are reused across forwards, so steady-state inference
+// does not copy blobs. Not thread-safe; one backend per inference thread.
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    virtual const char* Name() const = 0;
+
+    // Intra-op threads per forward, 0 = runtime default. Call before Load().
+    // OpenCV's thread pool is process-wide, so for OpenCvBackend this applies
+    // to every network in the process.
+    void SetNumThreads(int threads) { threads_ = threads; }
+
+    // Serialised, already optimised copy of the model, so a restart skips
+    // parsing and graph optimisation. Call before Load(): with reuse, Load()
+    // reads path (falling back to the ONNX if that fails); otherwise Load()
+    // writes it. Empty = none. Only ONNX Runtime supports this; OpenCV DNN
+    // cannot serialise an optimised Net and ignores it.
+    void SetOptimizedCache(const std::string& path, bool reuse) {
+        optimizedPath_ = path;
+        reuseOptimized_ = reuse;
+    }
+    // After Load(): the optimised model written or read, empty if none.
+    const std::string& OptimizedCache() const { return optimizedCache_; }
+    // After Load(): the model came from the optimised cache.
+    bool LoadedOptimized() const { return loadedOptimized_; }
+
+    // Loads an ONNX model for inputs of inputSize (W x H). Returns false and
+    // logs on failure.
+    virtual bool Load(const std::string& modelPath, cv::Size inputSize) = 0;
+
+    // Input buffer for `batch` images; grows if needed, so call it before
+    // filling, not once up front.
+    virtual float* InputBuffer(int batch) = 0;
+
+    // Runs the network on the first `batch` images of the input buffer.
+    // Throws (cv::Exception / std::exception) if the model rejects the batch.
+    virtual void Forward(int batch) = 0;
+
+    virtual TensorView Output(int index = 0) const = 0;
+
+    cv::Size InputSize() const { return inputSize_; }
+
+    // Runs `runs` forwards on a letterbox-grey 1 x 3 x H x W input, so layer
+    // allocation, weight repacking and thread-pool start-up are paid before
+    // the first camera frame. Returns the last run's forward time, in ms, as
+    // a steady-state estimate.
+    double Warmup(int runs);
+
+protected:
+    cv::Size inputSize_;
+    int threads_ = 0;
+    std::string optimizedPath_, optimizedCache_;
+    bool reuseOptimized_ = false;
+    bool loadedOptimized_ = false;
+};
+
+// OpenCV DNN, CPU target. The Net stays reachable for OpenCV-only features
+// (Net::quantize).
+class OpenCvBackend : public InferenceBackend {
+public:
+    const char* Name() const override { return "opencv"; }
+    bool Load(const std::string& modelPath, cv::Size inputSize) override;
+    float* InputBuffer(int batch) override;
+    void Forward(int batch) override;
+    TensorView Output(int index = 0) const override;
+
+    cv::dnn::Net& Net() { return net_; }
+
+private:
+    cv::dnn::Net net_;
+    std::vector<cv::String> outNames_;
+    cv::Mat input_;                    // capacity x 3 x H x W
+    std::vector<cv::Mat> inputHeaders_; // per batch size, over input_
+    std::vector<cv::Mat> outputs_;
+};
+
+enum class BackendKind { OpenCV, OnnxRuntime };
+
+// "opencv" or "ort" / "onnxruntime".
+bool ParseBackendKind(const std::string& text, BackendKind& kind);
+const char* BackendKindName(BackendKind kind);
+
+// nullptr if kind was not compiled in (ONNX Runtime needs HAVE_ONNXRUNTIME).
+std::unique_ptr<InferenceBackend> CreateInferenceBackend(BackendKind kind);
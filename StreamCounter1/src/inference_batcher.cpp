@@ -0,0 +1,218 @@
+#include "inference_batcher.hpp"
+#include "bench_stats.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+InferenceBatcher::InferenceBatcher(InferenceBackend& backend, const DetectorConfig& detector,
+                                   const Config& config, ResultCallback callback)
+    : backend_(backend), detector_(detector), config_(config), callback_(std::move(callback)),
+      maxBatch_(std::max(1, config.maxBatch)) {
+    const cv::Size input = detector_.inputSize;
+    planeFloats_ = (size_t)3 * input.area();
+
+    backend_.InputBuffer(maxBatch_.load());
+    decoder_.SetClassFilter(detector_.classIds);
+    nms_.SetTopK(detector_.nmsTopK);
+    slots_.resize(maxBatch_.load());
+    for (Slot& slot : slots_)
+        slot.planes.resize(planeFloats_);
+}
+
+InferenceBatcher::~InferenceBatcher() {
+    Stop();
+}
+
+int InferenceBatcher::AddStream(const cv::Rect& roi) {
+    auto stream = std::make_unique<Stream>();
+    stream->stager.Configure(roi, detector_.inputSize);
+    stream->pending.resize(planeFloats_);
+    stream->ready.resize(planeFloats_);
+    streams_.push_back(std::move(stream));
+    return (int)streams_.size() - 1;
+}
+
+void InferenceBatcher::Start() {
+    if (thread_.joinable())
+        return;
+    stop_ = false;
+    thread_ = std::thread(&InferenceBatcher::Loop, this);
+}
+
+void InferenceBatcher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void InferenceBatcher::SubmitNV12(int streamId, const uint8_t* yPlane, int yStride,
+                                  const uint8_t* uvPlane, int uvStride, int width, int height,
+                                  int64_t timestamp) {
+    Stream& stream = *streams_[streamId];
+    stream.pendingTransform = stream.stager.StageNV12(yPlane, yStride, uvPlane, uvStride, width,
+                                                      height, stream.pending.data());
+    Publish(stream, timestamp);
+}
+
+void InferenceBatcher::SubmitBGR(int streamId, const cv::Mat& bgr, int64_t timestamp) {
+    Stream& stream = *streams_[streamId];
+    stream.pendingTransform = stream.stager.StageBGR(bgr, stream.pending.data());
+    Publish(stream, timestamp);
+}
+
+void InferenceBatcher::Publish(Stream& stream, int64_t timestamp) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stream.ready.swap(stream.pending);
+        stream.readyTransform = stream.pendingTransform;
+        stream.readyTimestamp = timestamp;
+        if (!stream.hasReady) {
+            stream.hasReady = true;
+            if (readyCount_++ == 0)
+                firstReady_ = Clock::now();
+        }
+    }
+    cv_.notify_one();
+}
+
+void InferenceBatcher::Loop() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        cv_.wait(lock, [&] { return stop_ || readyCount_ > 0; });
+        // Drain: frames submitted before Stop() still get their result
+        if (stop_ && readyCount_ == 0)
+            break;
+
+        const int maxBatch = MaxBatch();
+        const auto deadline = firstReady_ + std::chrono::duration_cast<Clock::duration>(
+                                                std::chrono::duration<double, std::milli>(config_.maxWaitMs));
+        cv_.wait_until(lock, deadline, [&] {
+            return stop_ || readyCount_ >= std::min(maxBatch, (int)streams_.size());
+        });
+
+        const int n = CollectLocked(maxBatch);
+        lock.unlock();
+        RunBatch(n);
+        lock.lock();
+    }
+}
+
+int InferenceBatcher::CollectLocked(int maxBatch) {
+    const int numStreams = (int)streams_.size();
+    int n = 0;
+    for (int i = 0; i < numStreams && n < maxBatch; ++i) {
+        const int id = (cursor_ + i) % numStreams;
+        Stream& stream = *streams_[id];
+        if (!stream.hasReady)
+            continue;
+        Slot& slot = slots_[n++];
+        slot.streamId = id;
+        slot.timestamp = stream.readyTimestamp;
+        slot.transform = stream.readyTransform;
+        slot.planes.swap(stream.ready);
+        stream.hasReady = false;
+        --readyCount_;
+    }
+    cursor_ = (cursor_ + 1) % std::max(1, numStreams);
+    if (readyCount_ > 0)
+        firstReady_ = Clock::now();
+    return n;
+}
+
+void InferenceBatcher::RunBatch(int n) {
+    if (n == 0)
+        return;
+
+    float* dst = backend_.InputBuffer(n);
+    for (int i = 0; i < n; ++i)
+        std::memcpy(dst + i * planeFloats_, slots_[i].planes.data(), planeFloats_ * sizeof(float));
+
+    auto start = BenchClock::now();
+    if (Forward(n)) {
+        Report(n, backend_.Output(0), MsSince(start));
+        return;
+    }
+    if (n == 1) {
+        ReportFailed(0, 1);
+        return;
+    }
+
+    std::cerr << "[Batch] Model rejected batch " << n
+              << " (export it with a dynamic batch axis); falling back to batch 1\n";
+    maxBatch_.store(1, std::memory_order_relaxed);
+    for (int i = 0; i < n; ++i) {
+        std::memcpy(backend_.InputBuffer(1), slots_[i].planes.data(), planeFloats_ * sizeof(float));
+        start = BenchClock::now();
+        if (!Forward(1)) {
+            ReportFailed(i, 1);
+            continue;
+        }
+        std::swap(slots_[0], slots_[i]);
+        Report(1, backend_.Output(0), MsSince(start));
+        std::swap(slots_[0], slots_[i]);
+    }
+}
+
+void InferenceBatcher::ReportFailed(int i, int n) {
+    BatchResult result;
+    result.streamId = slots_[i].streamId;
+    result.timestamp = slots_[i].timestamp;
+    result.batchSize = n;
+    if (callback_)
+        callback_(result);
+}
+
+bool InferenceBatcher::Forward(int n) {
+    try {
+        backend_.Forward(n);
+    } catch (const std::exception& e) {
+        if (n == 1)
+            std::cerr << "[Batch] Inference error: " << e.what() << "\n";
+        return false;
+    }
+    const TensorView output = backend_.Output(0);
+    return output.data && output.dims == 3 && output.shape[0] == n;
+}
+
+void InferenceBatcher::Report(int n, const TensorView& output, double forwardMs) {
+    // [n, 4+C, A] or [n, A, 4+C]; decode each slice as its own [1, ., .] head
+    const size_t sliceFloats = (size_t)output.shape[1] * output.shape[2];
+
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    frames_.fetch_add(n, std::memory_order_relaxed);
+
+    for (int i = 0; i < n; ++i) {
+        const Slot& slot = slots_[i];
+        Stream& stream = *streams_[slot.streamId];
+        const float threshold = detector_.DecodeThreshold();
+        decoder_.Decode(output.data + i * sliceFloats, output.shape[1], output.shape[2], threshold,
+                        slot.transform);
+        if (detector_.agnosticNms)
+            nms_.Run(decoder_.Boxes(), decoder_.Scores(), threshold, detector_.nmsThreshold, indices_);
+        else
+            nms_.Run(decoder_.Boxes(), decoder_.Scores(), decoder_.ClassIds(), threshold,
+                     detector_.nmsThreshold, indices_);
+
+        BatchResult result;
+        result.streamId = slot.streamId;
+        result.timestamp = slot.timestamp;
+        result.batchSize = n;
+        result.forwardMs = forwardMs;
+        stream.detections.clear();
+        for (int idx : indices_) {
+            const int classId = decoder_.ClassIds()[idx];
+            const float score = decoder_.Scores()[idx];
+            stream.detections.push_back({ classId, score, decoder_.Boxes()[idx] });
+            if (classId == detector_.countClassId && score > detector_.confThreshold)
+                result.count++;
+        }
+        result.detections = &stream.detections;
+        if (callback_)
+            callback_(result);
+    }
+}
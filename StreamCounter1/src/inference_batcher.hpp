@@ -0,0 +1,138 @@
+#pragma once
+
+#include "frame_stager.hpp"
+#include "inference_backend.hpp"
+#include "nms.hpp"
+#include "yolo_decoder.hpp"
+#include "yolo_detector.hpp"
+
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Result of one stream's frame out of a batched (InferenceBatcher) or
+// pooled (InferencePool) forward.
+struct BatchResult {
+    int streamId = 0;
+    int64_t timestamp = 0; // as passed to Submit*
+    int count = 0;
+    const std::vector<Detection>* detections = nullptr; // valid during the callback only; nullptr if the forward failed
+    int batchSize = 0;
+    double forwardMs = 0.0; // whole batch
+    int instance = 0;       // InferencePool instance that ran it
+};
+
+// Coalesces frames from several camera streams into one N x 3 x H x W input.
+//
+// Each stream has a latest-frame slot: Submit* letterboxes the frame on the
+// caller's thread into a private buffer and swaps it into the slot, so a
+// stream never queues more than one frame and stale frames are replaced.
+// The batch thread forwards as soon as maxBatch streams are ready, or
+// maxWaitMs after the first one became ready, then decodes, runs NMS and
+// reports each slice separately. The model must be exported with a dynamic
+// batch axis; if forward rejects N > 1 the batcher falls back to batch 1.
+//
+// Call Submit* for a given stream from one thread at a time.
+class InferenceBatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ResultCallback = std::function<void(const BatchResult&)>;
+
+    struct Config {
+        int maxBatch = 4;
+        double maxWaitMs = 10.0;
+    };
+
+    // backend is used exclusively by the batch thread once Start() is called
+    // and must outlive the batcher.
+    InferenceBatcher(InferenceBackend& backend, const DetectorConfig& detector, const Config& config,
+                     ResultCallback callback);
+    ~InferenceBatcher();
+
+    // Registers a stream; call before Start(). roi is the stream's counting
+    // zone in frame pixels (empty = whole frame); only the crop is forwarded.
+    int AddStream(const cv::Rect& roi = cv::Rect());
+
+    void Start();
+    // Runs the frames already submitted, then joins the batch thread.
+    void Stop();
+
+    void SubmitNV12(int streamId, const uint8_t* yPlane, int yStride, const uint8_t* uvPlane,
+                    int uvStride, int width, int height, int64_t timestamp);
+    void SubmitBGR(int streamId, const cv::Mat& bgr, int64_t timestamp);
+
+    int MaxBatch() const { return maxBatch_.load(std::memory_order_relaxed); }
+    uint64_t Batches() const { return batches_.load(std::memory_order_relaxed); }
+    uint64_t Frames() const { return frames_.load(std::memory_order_relaxed); }
+    double MeanBatchSize() const {
+        uint64_t b = Batches();
+        return b ? (double)Frames() / b : 0.0;
+    }
+
+private:
+    struct Stream {
+        // Submitter side
+        FrameStager stager;
+        std::vector<float> pending;
+        BoxTransform pendingTransform;
+
+        // Guarded by mtx_
+        std::vector<float> ready;
+        BoxTransform readyTransform;
+        int64_t readyTimestamp = 0;
+        bool hasReady = false;
+
+        // Batch thread
+        std::vector<Detection> detections;
+    };
+
+    struct Slot {
+        int streamId = 0;
+        int64_t timestamp = 0;
+        BoxTransform transform;
+        std::vector<float> planes;
+    };
+
+    void Publish(Stream& stream, int64_t timestamp);
+    void Loop();
+    int CollectLocked(int maxBatch);
+    void RunBatch(int n);
+    bool Forward(int n);
+    void Report(int n, const TensorView& output, double forwardMs);
+    // Result with no detections for slot i, so waiters on a frame still wake.
+    void ReportFailed(int i, int n);
+
+    InferenceBackend& backend_;
+    DetectorConfig detector_;
+    Config config_;
+    ResultCallback callback_;
+    size_t planeFloats_ = 0; // 3 x H x W
+
+    std::vector<std::unique_ptr<Stream>> streams_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    int readyCount_ = 0;
+    Clock::time_point firstReady_{};
+    int cursor_ = 0; // round-robin start
+    bool stop_ = false;
+    std::thread thread_;
+
+    // Batch thread
+    std::vector<Slot> slots_;
+    YoloV8Decoder decoder_;
+    Nms nms_;
+    std::vector<int> indices_;
+
+    std::atomic<int> maxBatch_;
+    std::atomic<uint64_t> batches_{ 0 };
+    std::atomic<uint64_t> frames_{ 0 };
+};
@@ -0,0 +1,71 @@
+#include "inference_cadence.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+double MsBetween(InferenceCadence::Clock::time_point a, InferenceCadence::Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+} // namespace
+
+InferenceCadence::InferenceCadence(const Config& config)
+    : config_(config),
+      interval_(std::min(std::max(config.initialInterval, config.minInterval), config.maxInterval)) {}
+
+bool InferenceCadence::OnFrame(Clock::time_point now) {
+    if (lastFrame_ == Clock::time_point{}) {
+        windowStart_ = now;
+    } else {
+        double dt = MsBetween(lastFrame_, now);
+        framePeriodMs_ = framePeriodMs_ == 0.0 ? dt : framePeriodMs_ + config_.smoothing * (dt - framePeriodMs_);
+    }
+    lastFrame_ = now;
+
+    // Counters and the interval are refreshed once per second, which also
+    // keeps the cadence from oscillating frame to frame.
+    double windowMs = MsBetween(windowStart_, now);
+    if (windowMs >= 1000.0) {
+        uint64_t done = completed_.load(std::memory_order_relaxed);
+        inferenceFps_.store((done - windowInferences_) * 1000.0 / windowMs, std::memory_order_relaxed);
+        captureFps_.store(framePeriodMs_ > 0.0 ? 1000.0 / framePeriodMs_ : 0.0, std::memory_order_relaxed);
+        windowInferences_ = done;
+        windowStart_ = now;
+        UpdateInterval();
+    }
+
+    bool infer = framesSinceInference_ == 0;
+    if (++framesSinceInference_ >= Interval())
+        framesSinceInference_ = 0;
+    return infer;
+}
+
+void InferenceCadence::OnInferenceDone(double latencyMs) {
+    double current = latencyMs_.load(std::memory_order_relaxed);
+    double next = current == 0.0 ? latencyMs : current + config_.smoothing * (latencyMs - current);
+    latencyMs_.store(next, std::memory_order_relaxed);
+    completed_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InferenceCadence::UpdateInterval() {
+    const double period = framePeriodMs_;
+    const double latency = InferenceLatencyMs();
+    if (period <= 0.0 || latency <= 0.0)
+        return;
+
+    // The worker cannot start inferences faster than it completes them
+    int throughputFloor = (int)std::ceil(latency / period);
+
+    int interval = 1;
+    if (config_.policy == Policy::CpuBudget) {
+        interval = (int)std::ceil(latency / (config_.cpuBudget * period));
+    } else {
+        interval = (int)std::floor((config_.latencySloMs - latency) / period);
+    }
+
+    interval = std::max(interval, throughputFloor);
+    interval = std::min(std::max(interval, config_.minInterval), config_.maxInterval);
+    interval_.store(interval, std::memory_order_relaxed);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Picks the inference interval (run YOLO every N captured frames) at runtime
+// from the measured capture period P and inference latency L:
+//
+//   CpuBudget:  smallest N with L / (N * P) <= cpuBudget
+//   LatencySlo: largest N with N * P + L <= latencySloMs (count staleness)
+//
+// In both modes N >= ceil(L / P), since a single worker cannot start
+// inferences faster than it finishes them. OnFrame() is called by the
+// capture thread, OnInferenceDone() by the inference thread; the getters
+// are safe from any thread.
+class InferenceCadence {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Policy { CpuBudget, LatencySlo };
+
+    struct Config {
+        Policy policy = Policy::CpuBudget;
+        double cpuBudget = 0.5;      // fraction of wall time spent inferring
+        double latencySloMs = 500.0; // max age of a published count
+        int minInterval = 1;
+        int maxInterval = 30;
+        int initialInterval = 3;
+        double smoothing = 0.1;      // EWMA weight of the newest sample
+    };
+
+    InferenceCadence() : InferenceCadence(Config()) {}
+    explicit InferenceCadence(const Config& config);
+
+    // Capture thread: once per captured frame. Returns true when this frame
+    // should be handed to inference.
+    bool OnFrame(Clock::time_point now = Clock::now());
+
+    // Inference thread: wall time of one complete inference.
+    void OnInferenceDone(double latencyMs);
+
+    int Interval() const { return interval_.load(std::memory_order_relaxed); }
+    double InferenceFps() const { return inferenceFps_.load(std::memory_order_relaxed); }
+    double CaptureFps() const { return captureFps_.load(std::memory_order_relaxed); }
+    double InferenceLatencyMs() const { return latencyMs_.load(std::memory_order_relaxed); }
+
+private:
+    void UpdateInterval();
+
+    Config config_;
+
+    // Capture-thread state
+    Clock::time_point lastFrame_{};
+    Clock::time_point windowStart_{};
+    double framePeriodMs_ = 0.0;
+    uint64_t windowInferences_ = 0;
+    int framesSinceInference_ = 0;
+
+    std::atomic<uint64_t> completed_{ 0 };
+    std::atomic<double> latencyMs_{ 0.0 };
+    std::atomic<int> interval_;
+    std::atomic<double> inferenceFps_{ 0.0 };
+    std::atomic<double> captureFps_{ 0.0 };
+};
@@ -0,0 +1,227 @@
+#include "inference_pool.hpp"
+#include "bench_stats.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool PinCurrentThread(const std::vector<int>& cores) {
+    if (cores.empty())
+        return false;
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int core : cores)
+        mask |= (DWORD_PTR)1 << (core % (int)(sizeof(DWORD_PTR) * 8));
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int core : cores)
+        CPU_SET(core % CPU_SETSIZE, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+InferencePool::InferencePool(const Config& config, ResultCallback callback)
+    : config_(config), callback_(std::move(callback)) {
+    config_.threadsPerInstance = std::max(1, config_.threadsPerInstance);
+    if (config_.instances <= 0) {
+        const int hardware = (int)std::max(1u, std::thread::hardware_concurrency());
+        config_.instances = std::max(1, hardware / config_.threadsPerInstance);
+    }
+}
+
+InferencePool::~InferencePool() {
+    Stop();
+}
+
+int InferencePool::AddStream(const cv::Rect& roi) {
+    auto stream = std::make_unique<Stream>();
+    stream->stager.Configure(roi, cv::Size());
+    streams_.push_back(std::move(stream));
+    return (int)streams_.size() - 1;
+}
+
+bool InferencePool::Start(const DetectorConfig& detector) {
+    if (!instances_.empty())
+        return failed_ == 0;
+
+    inputSize_ = detector.inputSize;
+    const size_t planeFloats = (size_t)3 * inputSize_.area();
+    for (auto& stream : streams_) {
+        stream->stager.Configure(stream->stager.Roi(), inputSize_);
+        stream->pending.resize(planeFloats);
+        stream->ready.resize(planeFloats);
+    }
+
+    DetectorConfig config = detector;
+    config.threads = config_.threadsPerInstance;
+    const int hardware = (int)std::max(1u, std::thread::hardware_concurrency());
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = false;
+        loading_ = config_.instances;
+        failed_ = 0;
+    }
+    for (int i = 0; i < config_.instances; ++i) {
+        auto instance = std::make_unique<Instance>();
+        instance->planes.resize(planeFloats);
+        if (config_.pin) {
+            for (int k = 0; k < config_.threadsPerInstance; ++k)
+                instance->cores.push_back((i * config_.threadsPerInstance + k) % hardware);
+        }
+        instances_.push_back(std::move(instance));
+    }
+    for (int i = 0; i < config_.instances; ++i)
+        instances_[i]->thread = std::thread(&InferencePool::Worker, this, i, config);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [&] { return loading_ == 0; });
+    if (failed_ > 0)
+        std::cerr << "[Pool] " << failed_ << " of " << config_.instances << " instances failed to load\n";
+    return failed_ == 0;
+}
+
+void InferencePool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& instance : instances_) {
+        if (instance->thread.joinable())
+            instance->thread.join();
+    }
+}
+
+void InferencePool::SubmitNV12(int streamId, const uint8_t* yPlane, int yStride,
+                               const uint8_t* uvPlane, int uvStride, int width, int height,
+                               int64_t timestamp) {
+    Stream& stream = *streams_[streamId];
+    stream.pendingTransform = stream.stager.StageNV12(yPlane, yStride, uvPlane, uvStride, width,
+                                                      height, stream.pending.data());
+    Publish(stream, timestamp);
+}
+
+void InferencePool::SubmitBGR(int streamId, const cv::Mat& bgr, int64_t timestamp) {
+    Stream& stream = *streams_[streamId];
+    stream.pendingTransform = stream.stager.StageBGR(bgr, stream.pending.data());
+    Publish(stream, timestamp);
+}
+
+void InferencePool::Publish(Stream& stream, int64_t timestamp) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stream.ready.swap(stream.pending);
+        stream.readyTransform = stream.pendingTransform;
+        stream.readyTimestamp = timestamp;
+        if (stream.hasReady) {
+            replaced_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            stream.hasReady = true;
+            wake = !stream.busy;
+            if (wake)
+                ++readyCount_;
+        }
+    }
+    if (wake)
+        cv_.notify_one();
+}
+
+int InferencePool::TakeLocked(Instance& instance, BoxTransform& transform, int64_t& timestamp) {
+    const int numStreams = (int)streams_.size();
+    for (int i = 0; i < numStreams; ++i) {
+        const int id = (cursor_ + i) % numStreams;
+        Stream& stream = *streams_[id];
+        if (!stream.hasReady || stream.busy)
+            continue;
+        instance.planes.swap(stream.ready);
+        transform = stream.readyTransform;
+        timestamp = stream.readyTimestamp;
+        stream.hasReady = false;
+        stream.busy = true;
+        --readyCount_;
+        cursor_ = (id + 1) % numStreams;
+        return id;
+    }
+    return -1;
+}
+
+void InferencePool::Worker(int index, DetectorConfig config) {
+    Instance& instance = *instances_[index];
+    if (!instance.cores.empty() && !PinCurrentThread(instance.cores))
+        std::cerr << "[Pool] Cannot pin instance " << index << "\n";
+
+    const bool loaded = instance.detector.Load(config);
+    if (loaded)
+        instance.detector.Backend().Warmup(1);
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        failed_ += loaded ? 0 : 1;
+        --loading_;
+    }
+    cv_.notify_all();
+    if (!loaded)
+        return;
+
+    const size_t planeBytes = instance.planes.size() * sizeof(float);
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        cv_.wait(lock, [&] { return stop_ || readyCount_ > 0; });
+        if (stop_ && readyCount_ == 0)
+            break;
+        BoxTransform transform;
+        int64_t timestamp = 0;
+        const int streamId = TakeLocked(instance, transform, timestamp);
+        if (streamId < 0)
+            continue;
+        lock.unlock();
+
+        YoloDetector& detector = instance.detector;
+        const auto start = BenchClock::now();
+        std::memcpy(detector.Backend().InputBuffer(1), instance.planes.data(), planeBytes);
+        StageTimings t;
+        BatchResult result;
+        result.streamId = streamId;
+        result.timestamp = timestamp;
+        result.count = detector.CountStaged(transform, &t);
+        result.detections = &detector.Detections();
+        result.batchSize = 1;
+        result.forwardMs = t.forwardMs;
+        result.instance = index;
+        if (callback_)
+            callback_(result);
+        instance.busyUs.fetch_add((uint64_t)(MsSince(start) * 1000.0), std::memory_order_relaxed);
+        instance.frames.fetch_add(1, std::memory_order_relaxed);
+        frames_.fetch_add(1, std::memory_order_relaxed);
+
+        lock.lock();
+        // A frame that arrived while this stream was busy becomes eligible now
+        Stream& stream = *streams_[streamId];
+        stream.busy = false;
+        if (stream.hasReady) {
+            ++readyCount_;
+            cv_.notify_one();
+        }
+    }
+}
+
+InferencePool::InstanceStats InferencePool::Stats(int index) const {
+    const Instance& instance = *instances_[index];
+    InstanceStats stats;
+    stats.frames = instance.frames.load(std::memory_order_relaxed);
+    stats.busyMs = instance.busyUs.load(std::memory_order_relaxed) / 1000.0;
+    for (size_t i = 0; i < instance.cores.size(); ++i)
+        stats.cores += (i ? "," : "") + std::to_string(instance.cores[i]);
+    return stats;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "frame_stager.hpp"
+#include "inference_batcher.hpp"
+#include "yolo_detector.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// M independent detector instances, each with its own network, K intra-op
+// threads and a worker thread, serving many camera streams at once.
+//
+// Streams have the same latest-frame slot as InferenceBatcher: Submit*
+// letterboxes on the caller's thread and replaces any frame still waiting.
+// A free instance takes the next ready stream round-robin; a stream is never
+// on two instances at once, so its results arrive in order. Callbacks run on
+// the instance threads, concurrently for different streams.
+//
+// With pinning, instance i's worker is bound to cores [i*K, i*K + K) and
+// loads its model there, so runtime threads created at load (ONNX Runtime's
+// intra-op pool) inherit that core set. OpenCV DNN has one process-wide
+// thread pool; use K = 1 with it, or the instances contend inside it.
+class InferencePool {
+public:
+    using ResultCallback = std::function<void(const BatchResult&)>;
+
+    struct Config {
+        int instances = 0;          // 0 = hardware threads / threadsPerInstance
+        int threadsPerInstance = 1;
+        bool pin = false;
+    };
+
+    struct InstanceStats {
+        uint64_t frames = 0;
+        double busyMs = 0.0; // forward, decode, NMS and callback
+        std::string cores;   // pinned core set, empty if not pinned
+    };
+
+    InferencePool(const Config& config, ResultCallback callback);
+    ~InferencePool();
+
+    // Registers a stream; call before Start(). roi is the stream's counting
+    // zone in frame pixels (empty = whole frame).
+    int AddStream(const cv::Rect& roi = cv::Rect());
+
+    // Loads one detector per instance on its worker thread and starts
+    // serving. detector should have resolved model paths (e.g. from a
+    // ModelManager); its threads field is replaced by threadsPerInstance.
+    // Returns false if any instance failed to load.
+    bool Start(const DetectorConfig& detector);
+    // Runs the frames already submitted, then joins the instance threads.
+    void Stop();
+
+    void SubmitNV12(int streamId, const uint8_t* yPlane, int yStride, const uint8_t* uvPlane,
+                    int uvStride, int width, int height, int64_t timestamp);
+    void SubmitBGR(int streamId, const cv::Mat& bgr, int64_t timestamp);
+
+    int Instances() const { return (int)instances_.size(); }
+    int ThreadsPerInstance() const { return config_.threadsPerInstance; }
+    uint64_t Frames() const { return frames_.load(std::memory_order_relaxed); }
+    // Frames replaced in their slot before any instance picked them up.
+    uint64_t Replaced() const { return replaced_.load(std::memory_order_relaxed); }
+    InstanceStats Stats(int instance) const;
+
+private:
+    struct Stream {
+        // Submitter side
+        FrameStager stager;
+        std::vector<float> pending;
+        BoxTransform pendingTransform;
+
+        // Guarded by mtx_
+        std::vector<float> ready;
+        BoxTransform readyTransform;
+        int64_t readyTimestamp = 0;
+        bool hasReady = false;
+        bool busy = false; // on an instance
+    };
+
+    struct Instance {
+        YoloDetector detector;
+        std::thread thread;
+        std::vector<float> planes; // swapped with a stream's ready buffer
+        std::vector<int> cores;
+        std::atomic<uint64_t> frames{ 0 };
+        std::atomic<uint64_t> busyUs{ 0 };
+    };
+
+    void Publish(Stream& stream, int64_t timestamp);
+    void Worker(int index, DetectorConfig detector);
+    int TakeLocked(Instance& instance, BoxTransform& transform, int64_t& timestamp);
+
+    Config config_;
+    ResultCallback callback_;
+    cv::Size inputSize_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::vector<std::unique_ptr<Instance>> instances_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    int readyCount_ = 0;
+    int cursor_ = 0; // round-robin start
+    int loading_ = 0;
+    int failed_ = 0;
+    bool stop_ = false;
+
+    std::atomic<uint64_t> frames_{ 0 };
+    std::atomic<uint64_t> replaced_{ 0 };
+};
+
+// Binds the calling thread to the given cores. Returns false if the
+// platform call fails or is unavailable.
+bool PinCurrentThread(const std::vector<int>& cores);
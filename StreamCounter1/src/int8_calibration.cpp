@@ -0,0 +1,114 @@
+#include "int8_calibration.hpp"
+#include "letterbox.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+bool IsImagePath(const std::string& path) {
+    std::string ext = path.substr(path.find_last_of('.') + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == "jpg" || ext == "jpeg" || ext == "png" || ext == "bmp";
+}
+
+} // namespace
+
+bool CollectCalibrationFrames(const std::vector<std::string>& sources, int maxFrames,
+                              int videoStride, std::vector<cv::Mat>& frames) {
+    frames.clear();
+    videoStride = std::max(1, videoStride);
+    for (const std::string& source : sources) {
+        if ((int)frames.size() >= maxFrames)
+            break;
+        if (IsImagePath(source)) {
+            cv::Mat image = cv::imread(source, cv::IMREAD_COLOR);
+            if (image.empty()) {
+                std::cerr << "[INT8] Cannot read " << source << "\n";
+                continue;
+            }
+            frames.push_back(image);
+            continue;
+        }
+
+        cv::VideoCapture cap(source);
+        if (!cap.isOpened()) {
+            std::cerr << "[INT8] Cannot open " << source << "\n";
+            continue;
+        }
+        cv::Mat frame;
+        for (long index = 0; (int)frames.size() < maxFrames && cap.read(frame); ++index) {
+            if (index % videoStride == 0)
+                frames.push_back(frame.clone());
+        }
+    }
+    return !frames.empty();
+}
+
+bool SaveCalibrationFrames(const std::string& dir, const std::vector<cv::Mat>& frames) {
+    char name[32];
+    for (size_t i = 0; i < frames.size(); ++i) {
+        std::snprintf(name, sizeof(name), "/calib_%03zu.jpg", i);
+        if (!cv::imwrite(dir + name, frames[i], { cv::IMWRITE_JPEG_QUALITY, 95 })) {
+            std::cerr << "[INT8] Cannot write " << dir << name << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LoadCalibrationFrames(const std::string& dir, std::vector<cv::Mat>& frames) {
+    frames.clear();
+    std::vector<cv::String> paths, png;
+    cv::glob(dir + "/*.jpg", paths, false);
+    cv::glob(dir + "/*.png", png, false);
+    paths.insert(paths.end(), png.begin(), png.end());
+    std::sort(paths.begin(), paths.end());
+    for (const cv::String& path : paths) {
+        cv::Mat image = cv::imread(path, cv::IMREAD_COLOR);
+        if (!image.empty())
+            frames.push_back(image);
+    }
+    return !frames.empty();
+}
+
+cv::Mat MakeCalibrationBlob(const std::vector<cv::Mat>& frames, cv::Size inputSize) {
+    const int shape[] = { (int)frames.size(), 3, inputSize.height, inputSize.width };
+    cv::Mat blob(4, shape, CV_32F);
+    const size_t planeFloats = (size_t)3 * inputSize.area();
+    cv::Mat resized, converted;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const LetterboxGeometry g =
+            ComputeLetterbox(frames[i].cols, frames[i].rows, inputSize.width, inputSize.height);
+        LetterboxBgrInto(frames[i], g, blob.ptr<float>() + i * planeFloats, resized, converted);
+    }
+    return blob;
+}
+
+bool QuantizeNet(cv::dnn::Net& net, const cv::Mat& calibrationBlob) {
+    if (calibrationBlob.empty())
+        return false;
+    try {
+        net = net.quantize(calibrationBlob, CV_32F, CV_32F, true);
+        return true;
+    } catch (const cv::Exception& e) {
+        if (calibrationBlob.size[0] == 1) {
+            std::cerr << "[INT8] Quantize failed: " << e.what() << "\n";
+            return false;
+        }
+        std::cerr << "[INT8] Batched calibration rejected, using the first frame only\n";
+    }
+    try {
+        const int shape[] = { 1, calibrationBlob.size[1], calibrationBlob.size[2], calibrationBlob.size[3] };
+        cv::Mat first(4, shape, CV_32F, (void*)calibrationBlob.ptr<float>());
+        net = net.quantize(first, CV_32F, CV_32F, true);
+        return true;
+    } catch (const cv::Exception& e) {
+        std::cerr << "[INT8] Quantize failed: " << e.what() << "\n";
+        return false;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#include <string>
+#include <vector>
+
+// INT8 post-training quantisation with OpenCV DNN (Net::quantize).
+//
+// OpenCV cannot serialise a quantised Net, so the offline step
+// (calibrate_int8) only selects and stores representative frames from our
+// own footage; YoloDetector re-quantises from that set at load time, which
+// costs one forward per calibration frame. A pre-quantised ONNX (QDQ
+// export) is loaded directly instead when one is present.
+
+// Samples frames from images and videos: images are taken as-is, videos
+// every videoStride frames. Stops after maxFrames in total.
+bool CollectCalibrationFrames(const std::vector<std::string>& sources, int maxFrames,
+                              int videoStride, std::vector<cv::Mat>& frames);
+
+// Writes frames as <dir>/calib_000.jpg, calib_001.jpg, ...
+bool SaveCalibrationFrames(const std::string& dir, const std::vector<cv::Mat>& frames);
+
+// Loads every *.jpg / *.png in dir, sorted by name.
+bool LoadCalibrationFrames(const std::string& dir, std::vector<cv::Mat>& frames);
+
+// N x 3 x H x W, letterboxed exactly like inference frames.
+cv::Mat MakeCalibrationBlob(const std::vector<cv::Mat>& frames, cv::Size inputSize);
+
+// Replaces net with its INT8 version (float inputs and outputs, per-channel
+// weights). Falls back to calibrating on the first frame only if the model
+// has a fixed batch of 1. Returns false and leaves net untouched on failure.
+bool QuantizeNet(cv::dnn::Net& net, const cv::Mat& calibrationBlob);
@@ -0,0 +1,69 @@
+#include "label_replay.hpp"
+
+#include <fstream>
+#include <sstream>
+
+bool LoadLabelSequence(const std::string& dir, const std::string& stem, LabelSequence& frames) {
+    frames.clear();
+    for (int index = 1;; ++index) {
+        std::ifstream ifs(dir + "/" + stem + "_" + std::to_string(index) + ".txt");
+        if (!ifs.is_open())
+            break;
+
+        std::vector<LabelBox> labels;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            std::istringstream iss(line);
+            LabelBox box;
+            if (!(iss >> box.classId >> box.cx >> box.cy >> box.w >> box.h))
+                continue;
+            if (!(iss >> box.confidence))
+                box.confidence = 1.f;
+            labels.push_back(box);
+        }
+        frames.push_back(std::move(labels));
+    }
+    return !frames.empty();
+}
+
+bool LoadLabelSequenceFromDefaultPaths(const std::string& dir, const std::string& stem,
+                                       LabelSequence& frames) {
+    static const char* kPrefixes[] = { "", "../", "../../" };
+    for (const char* prefix : kPrefixes) {
+        if (LoadLabelSequence(prefix + dir, stem, frames))
+            return true;
+    }
+    return false;
+}
+
+cv::Rect LabelToRect(const LabelBox& label, int frameWidth, int frameHeight) {
+    float w = label.w * frameWidth;
+    float h = label.h * frameHeight;
+    return cv::Rect((int)(label.cx * frameWidth - 0.5f * w), (int)(label.cy * frameHeight - 0.5f * h),
+                    (int)w, (int)h);
+}
+
+void SynthesizeCandidates(const std::vector<LabelBox>& labels, int frameWidth, int frameHeight,
+                          int perLabel, cv::RNG& rng, CandidateFrame& out, float lowRate) {
+    out.Clear();
+    for (const LabelBox& label : labels) {
+        cv::Rect box = LabelToRect(label, frameWidth, frameHeight);
+        float topScore = 0.70f + 0.25f * (float)rng.uniform(0.0, 1.0);
+        if (lowRate > 0.f && rng.uniform(0.f, 1.f) < lowRate)
+            topScore = 0.20f + 0.25f * (float)rng.uniform(0.0, 1.0);
+        out.boxes.push_back(box);
+        out.scores.push_back(topScore);
+        out.classIds.push_back(label.classId);
+
+        for (int k = 1; k < perLabel; ++k) {
+            // Neighbouring anchors: a few percent of shift and scale, lower score
+            int dx = (int)(box.width * rng.uniform(-0.08, 0.08));
+            int dy = (int)(box.height * rng.uniform(-0.08, 0.08));
+            int dw = (int)(box.width * rng.uniform(-0.10, 0.10));
+            int dh = (int)(box.height * rng.uniform(-0.10, 0.10));
+            out.boxes.emplace_back(box.x + dx, box.y + dy, box.width + dw, box.height + dh);
+            out.scores.push_back(topScore * (float)rng.uniform(0.55, 0.98));
+            out.classIds.push_back(label.classId);
+        }
+    }
+}
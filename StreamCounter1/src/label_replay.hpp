@@ -0,0 +1,52 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+// YOLO label files (one per frame, "class cx cy w h [conf]" normalised to
+// [0, 1]) as written by `yolo predict save_txt=True`, e.g.
+// runs/detect/predict4/labels/Video_1.txt ... Video_301.txt.
+
+struct LabelBox {
+    int classId = 0;
+    float cx = 0.f;
+    float cy = 0.f;
+    float w = 0.f;
+    float h = 0.f;
+    float confidence = 1.f;
+};
+
+using LabelSequence = std::vector<std::vector<LabelBox>>;
+
+// Loads <dir>/<stem>_1.txt, <stem>_2.txt, ... until the first missing index.
+// Returns false if no frame could be read.
+bool LoadLabelSequence(const std::string& dir, const std::string& stem, LabelSequence& frames);
+
+// Tries dir as given, then relative to the parent directories (for runs from build/).
+bool LoadLabelSequenceFromDefaultPaths(const std::string& dir, const std::string& stem,
+                                       LabelSequence& frames);
+
+cv::Rect LabelToRect(const LabelBox& label, int frameWidth, int frameHeight);
+
+// Raw detector output for one frame, before NMS.
+struct CandidateFrame {
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::vector<int> classIds;
+
+    void Clear() {
+        boxes.clear();
+        scores.clear();
+        classIds.clear();
+    }
+};
+
+// Expands every label into perLabel candidates the way a YOLO head fires
+// several neighbouring anchors on one object: the label itself with a high
+// score plus jittered, lower-scored duplicates. A lowRate fraction of the
+// labels instead get a best score of 0.2 - 0.45, like a partly occluded
+// object, which only a tracker's low-score pass keeps. Deterministic for a
+// given rng.
+void SynthesizeCandidates(const std::vector<LabelBox>& labels, int frameWidth, int frameHeight,
+                          int perLabel, cv::RNG& rng, CandidateFrame& out, float lowRate = 0.f);
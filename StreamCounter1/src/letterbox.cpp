@@ -0,0 +1,40 @@
+#include "letterbox.hpp"
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+void FillLetterboxPadding(float* planes, const LetterboxGeometry& g) {
+    const size_t planeSize = (size_t)g.dstWidth * g.dstHeight;
+    const int rightPad = g.dstWidth - g.padX - g.innerWidth;
+    for (int c = 0; c < 3; ++c) {
+        float* plane = planes + c * planeSize;
+        for (int y = 0; y < g.dstHeight; ++y) {
+            float* row = plane + (size_t)y * g.dstWidth;
+            if (y < g.padY || y >= g.padY + g.innerHeight) {
+                std::fill(row, row + g.dstWidth, kLetterboxPadValue);
+            } else {
+                std::fill(row, row + g.padX, kLetterboxPadValue);
+                std::fill(row + g.padX + g.innerWidth, row + g.padX + g.innerWidth + rightPad,
+                          kLetterboxPadValue);
+            }
+        }
+    }
+}
+
+void LetterboxBgrInto(const cv::Mat& bgr, const LetterboxGeometry& g, float* planes,
+                      cv::Mat& resized, cv::Mat& converted) {
+    FillLetterboxPadding(planes, g);
+
+    cv::resize(bgr, resized, cv::Size(g.innerWidth, g.innerHeight), 0, 0, cv::INTER_LINEAR);
+    resized.convertTo(converted, CV_32F, 1.0 / 255.0);
+
+    // Split straight into the inner ROI of each plane, swapping B and R
+    const size_t planeSize = (size_t)g.dstWidth * g.dstHeight;
+    const cv::Rect inner(g.padX, g.padY, g.innerWidth, g.innerHeight);
+    cv::Mat channels[3];
+    for (int c = 0; c < 3; ++c) {
+        cv::Mat plane(g.dstHeight, g.dstWidth, CV_32F, planes + (2 - c) * planeSize);
+        channels[c] = plane(inner);
+    }
+    cv::split(converted, channels);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "yolo_decoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Aspect-preserving fit of a srcWidth x srcHeight frame into a
+// dstWidth x dstHeight network input, centred with constant padding.
+struct LetterboxGeometry {
+    int srcWidth = 0;
+    int srcHeight = 0;
+    int dstWidth = 0;
+    int dstHeight = 0;
+    float scale = 1.f; // dst pixels per src pixel
+    int innerWidth = 0;
+    int innerHeight = 0;
+    int padX = 0;
+    int padY = 0;
+
+    BoxTransform ToBoxTransform() const {
+        BoxTransform t;
+        t.scaleX = t.scaleY = 1.f / scale;
+        t.offsetX = (float)padX;
+        t.offsetY = (float)padY;
+        return t;
+    }
+};
+
+inline LetterboxGeometry ComputeLetterbox(int srcWidth, int srcHeight, int dstWidth, int dstHeight) {
+    LetterboxGeometry g;
+    g.srcWidth = srcWidth;
+    g.srcHeight = srcHeight;
+    g.dstWidth = dstWidth;
+    g.dstHeight = dstHeight;
+    g.scale = std::min((float)dstWidth / srcWidth, (float)dstHeight / srcHeight);
+    g.innerWidth = std::min(dstWidth, (int)std::lround(srcWidth * g.scale));
+    g.innerHeight = std::min(dstHeight, (int)std::lround(srcHeight * g.scale));
+    g.padX = (dstWidth - g.innerWidth) / 2;
+    g.padY = (dstHeight - g.innerHeight) / 2;
+    return g;
+}
+
+// Grey padding used by the YOLOv8 training letterbox (114 / 255).
+constexpr float kLetterboxPadValue = 114.f / 255.f;
+
+// Writes kLetterboxPadValue into the padding of a 3 x dstHeight x dstWidth
+// planar float image, leaving the inner region untouched.
+void FillLetterboxPadding(float* planes, const LetterboxGeometry& g);
+
+// BGR frame -> letterboxed, normalised RGB planar floats at planes (3 x H x W),
+// padding included. resized and converted are caller-owned scratch Mats that
+// keep their buffers between calls.
+void LetterboxBgrInto(const cv::Mat& bgr, const LetterboxGeometry& g, float* planes,
+                      cv::Mat& resized, cv::Mat& converted);
@@ -0,0 +1,96 @@
+#include "line_counter.hpp"
+#include "byte_tracker.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+inline float Cross(cv::Point2f u, cv::Point2f v) {
+    return u.x * v.y - u.y * v.x;
+}
+
+// Last counted side of line i in a track's flags
+enum Side : uint32_t { kUnknown = 0, kNegative = 1, kPositive = 2 };
+
+} // namespace
+
+bool ParseCountingLine(const std::string& text, CountingLine& line) {
+    float x1 = 0.f, y1 = 0.f, x2 = 0.f, y2 = 0.f;
+    if (std::sscanf(text.c_str(), "%f,%f,%f,%f", &x1, &y1, &x2, &y2) != 4)
+        return false;
+    if (x1 == x2 && y1 == y2)
+        return false;
+    line.a = cv::Point2f(x1, y1);
+    line.b = cv::Point2f(x2, y2);
+    return true;
+}
+
+LineCounter::LineCounter(const std::vector<CountingLine>& lines, float hysteresis)
+    : lines_(lines.begin(), lines.begin() + std::min((int)lines.size(), kMaxLines)),
+      hysteresis_(std::max(0.f, hysteresis)),
+      counts_(new std::atomic<uint32_t>[2 * lines_.size()]) {
+    Reset();
+}
+
+void LineCounter::Reset() {
+    for (size_t i = 0; i < 2 * lines_.size(); ++i)
+        counts_[i].store(0, std::memory_order_relaxed);
+}
+
+void LineCounter::SetClassId(int classId) {
+    for (CountingLine& line : lines_)
+        line.classId = classId;
+}
+
+void LineCounter::Update(ByteTracker& tracker) {
+    const int numLines = (int)lines_.size();
+    for (int t = 0; t < tracker.Size(); ++t) {
+        // Lost tracks only coast on their prediction
+        if (!tracker.Confirmed(t) || !tracker.Matched(t))
+            continue;
+        const cv::Point2f p = tracker.Center(t);
+        uint32_t flags = tracker.Flags(t);
+        for (int i = 0; i < numLines; ++i) {
+            const CountingLine& line = lines_[i];
+            if (line.classId >= 0 && line.classId != tracker.ClassId(t))
+                continue;
+            // Signed distance from the line; inside the band the side is
+            // ambiguous and keeps its last value
+            const cv::Point2f dir = line.b - line.a;
+            const float length2 = dir.dot(dir);
+            const float cross = Cross(dir, p - line.a);
+            if (cross * cross <= hysteresis_ * hysteresis_ * length2)
+                continue;
+            const uint32_t side = cross > 0.f ? kPositive : kNegative;
+            const int shift = 2 * i;
+            const uint32_t last = (flags >> shift) & 3u;
+            if (side == last)
+                continue;
+            flags = (flags & ~(3u << shift)) | (side << shift);
+            if (last == kUnknown)
+                continue;
+            // Only a crossing alongside the segment counts
+            const float along = dir.dot(p - line.a);
+            if (along < 0.f || along > length2)
+                continue;
+            const int dirIndex = side == kPositive ? 0 : 1; // 0 = in, 1 = out
+            counts_[2 * i + dirIndex].fetch_add(1, std::memory_order_relaxed);
+        }
+        tracker.SetFlags(t, flags);
+    }
+}
+
+uint32_t LineCounter::TotalIn() const {
+    uint32_t total = 0;
+    for (int i = 0; i < Lines(); ++i)
+        total += In(i);
+    return total;
+}
+
+uint32_t LineCounter::TotalOut() const {
+    uint32_t total = 0;
+    for (int i = 0; i < Lines(); ++i)
+        total += Out(i);
+    return total;
+}
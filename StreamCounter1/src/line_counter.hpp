@@ -0,0 +1,64 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ByteTracker;
+
+// Directed counting line in frame pixels. Crossing from the negative to the
+// positive side of a -> b counts as "in": for a line drawn left to right,
+// that is moving down the image.
+struct CountingLine {
+    cv::Point2f a, b;
+    int classId = -1; // -1 = every class
+};
+
+// Parses "x1,y1,x2,y2" in frame pixels.
+bool ParseCountingLine(const std::string& text, CountingLine& line);
+
+// In / out counters for a stream's counting lines, fed from its tracker.
+//
+// After each tracker update or prediction, every confirmed track that was
+// matched at the last update is tested once per line with a constant-time
+// orientation test; lost tracks coasting on their prediction are not
+// counted. Each track remembers the side of each line it was last counted
+// on, in its ByteTracker::Flags (two bits per line, hence kMaxLines). A side
+// only registers once the centre is more than hysteresis pixels from the
+// line, and a change of side counts one in or out if the centre is then
+// alongside the segment (a track that goes round an end only has its side
+// updated). Counts are net side changes: an object that crosses and comes
+// back adds one in and one out, while jitter on the line adds nothing.
+//
+// Counts are atomics: Update() runs on the inference thread while display
+// or reporting threads read In() / Out().
+class LineCounter {
+public:
+    static constexpr int kMaxLines = 16;
+    static constexpr float kDefaultHysteresis = 8.f; // px
+
+    LineCounter() = default;
+    // Lines beyond kMaxLines are ignored.
+    explicit LineCounter(const std::vector<CountingLine>& lines, float hysteresis = kDefaultHysteresis);
+
+    void Update(ByteTracker& tracker);
+    void Reset();
+    // Counts only classId (-1 = every class) on every line, e.g. once the
+    // model's class names are known. Not thread-safe against Update().
+    void SetClassId(int classId);
+
+    int Lines() const { return (int)lines_.size(); }
+    const CountingLine& Line(int i) const { return lines_[i]; }
+    uint32_t In(int line) const { return counts_[2 * line].load(std::memory_order_relaxed); }
+    uint32_t Out(int line) const { return counts_[2 * line + 1].load(std::memory_order_relaxed); }
+    uint32_t TotalIn() const;
+    uint32_t TotalOut() const;
+
+private:
+    std::vector<CountingLine> lines_;
+    float hysteresis_ = kDefaultHysteresis;
+    std::unique_ptr<std::atomic<uint32_t>[]> counts_; // in, out per line
+};
@@ -0,0 +1,119 @@
+#include "mjpeg_decoder.hpp"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include <jpeglib.h>
+
+struct MjpegDecoder::Impl {
+    // libjpeg reports fatal errors through error_exit, which must not return
+    struct ErrorManager {
+        jpeg_error_mgr pub;
+        std::jmp_buf jump;
+        char message[JMSG_LENGTH_MAX];
+    };
+
+    static void OnError(j_common_ptr cinfo) {
+        ErrorManager* err = reinterpret_cast<ErrorManager*>(cinfo->err);
+        err->pub.format_message(cinfo, err->message);
+        std::longjmp(err->jump, 1);
+    }
+
+    // Corrupt-data warnings are routine with MJPEG; don't spam stderr
+    static void OnMessage(j_common_ptr, int) {}
+
+    Impl() {
+        cinfo.err = jpeg_std_error(&err.pub);
+        err.pub.error_exit = OnError;
+        err.pub.emit_message = OnMessage;
+        jpeg_create_decompress(&cinfo);
+    }
+
+    ~Impl() { jpeg_destroy_decompress(&cinfo); }
+
+    jpeg_decompress_struct cinfo;
+    ErrorManager err;
+    std::vector<JSAMPROW> rows;
+};
+
+MjpegDecoder::MjpegDecoder() : impl_(new Impl) {}
+
+MjpegDecoder::~MjpegDecoder() = default;
+
+int MjpegDecoder::ScaleFor(cv::Size frame, cv::Size input) {
+    if (frame.width <= 0 || frame.height <= 0)
+        return 1;
+    const double scale = std::min((double)input.width / frame.width, (double)input.height / frame.height);
+    int denom = 1;
+    while (denom < 8 && scale * denom * 2 <= 1.0)
+        denom *= 2;
+    return denom;
+}
+
+bool MjpegDecoder::ReadSize(const uint8_t* data, size_t bytes, cv::Size& size) {
+    jpeg_decompress_struct& cinfo = impl_->cinfo;
+    if (setjmp(impl_->err.jump)) {
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+    jpeg_mem_src(&cinfo, data, (unsigned long)bytes);
+    jpeg_read_header(&cinfo, TRUE);
+    size = cv::Size((int)cinfo.image_width, (int)cinfo.image_height);
+    jpeg_abort_decompress(&cinfo);
+    return true;
+}
+
+bool MjpegDecoder::Decode(const uint8_t* data, size_t bytes, int denom) {
+    return DecodeInto(data, bytes, denom, cv::Size(), cv::Rect(), scaled_, &denom_);
+}
+
+bool MjpegDecoder::DecodeForInput(const uint8_t* data, size_t bytes, cv::Size input, const cv::Rect& roi) {
+    return DecodeInto(data, bytes, 1, input, roi, scaled_, &denom_);
+}
+
+bool MjpegDecoder::DecodeFull(const uint8_t* data, size_t bytes) {
+    return DecodeInto(data, bytes, 1, cv::Size(), cv::Rect(), full_, nullptr);
+}
+
+bool MjpegDecoder::DecodeInto(const uint8_t* data, size_t bytes, int denom, cv::Size input, const cv::Rect& roi,
+                              cv::Mat& out, int* usedDenom) {
+    jpeg_decompress_struct& cinfo = impl_->cinfo;
+    if (!data || bytes == 0)
+        return false;
+    if (setjmp(impl_->err.jump)) {
+        std::cerr << "MJPEG decode failed: " << impl_->err.message << "\n";
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+
+    jpeg_mem_src(&cinfo, data, (unsigned long)bytes);
+    jpeg_read_header(&cinfo, TRUE);
+    int scale = denom;
+    if (!input.empty()) {
+        // Only the ROI is letterboxed; it must keep the input's resolution
+        const cv::Rect image(0, 0, (int)cinfo.image_width, (int)cinfo.image_height);
+        const cv::Rect crop = roi & image;
+        scale = ScaleFor(crop.empty() ? image.size() : crop.size(), input);
+    }
+    cinfo.out_color_space = JCS_EXT_BGR;
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = (unsigned)scale;
+    jpeg_start_decompress(&cinfo);
+
+    // Same size as the last frame: create() keeps the buffer
+    out.create((int)cinfo.output_height, (int)cinfo.output_width, CV_8UC3);
+    std::vector<JSAMPROW>& rows = impl_->rows;
+    rows.resize(cinfo.output_height);
+    for (int y = 0; y < out.rows; ++y)
+        rows[y] = out.ptr<uint8_t>(y);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        jpeg_read_scanlines(&cinfo, rows.data() + cinfo.output_scanline,
+                            cinfo.output_height - cinfo.output_scanline);
+    }
+    jpeg_finish_decompress(&cinfo);
+    if (usedDenom)
+        *usedDenom = scale;
+    return true;
+}
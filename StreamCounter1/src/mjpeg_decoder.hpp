@@ -0,0 +1,59 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// MJPEG frame decoder (UVC cameras, V4L2Capture with PixelFormat::MJPEG) on
+// libjpeg-turbo, scaling in the DCT domain.
+//
+// A frame headed for the network is decoded at 1/2, 1/4 or 1/8 size by
+// discarding high-frequency DCT coefficients, instead of decoding every
+// pixel and letterboxing most of them away: ScaleFor() picks the smallest
+// decode that still has at least the letterbox's resolution, so the
+// preprocessor only ever downsamples. With an ROI, the crop is what gets
+// letterboxed, so the scale is chosen for the ROI's size. DecodeFull() is the separate,
+// full-resolution decode for a preview; call it only on frames that are
+// shown. The decompressor and both output Mats are reused across frames.
+// Frames without Huffman tables (common for MJPEG) get the standard ones.
+// Not thread-safe; one per stream.
+class MjpegDecoder {
+public:
+    MjpegDecoder();
+    ~MjpegDecoder();
+    MjpegDecoder(const MjpegDecoder&) = delete;
+    MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+    // Largest denominator in {1, 2, 4, 8} whose frame / denom decode is
+    // still no smaller than frame letterboxed into input.
+    static int ScaleFor(cv::Size frame, cv::Size input);
+
+    // Frame size from the JPEG header, without decoding.
+    bool ReadSize(const uint8_t* data, size_t bytes, cv::Size& size);
+
+    // BGR decode at 1 / denom (1, 2, 4 or 8) into Scaled(); false on a
+    // corrupt frame.
+    bool Decode(const uint8_t* data, size_t bytes, int denom);
+    // Decode() at ScaleFor(frame, input), or ScaleFor(roi, input) for a
+    // non-empty roi (frame pixels); Denom() tells the scale used.
+    bool DecodeForInput(const uint8_t* data, size_t bytes, cv::Size input, const cv::Rect& roi = cv::Rect());
+    // Full-resolution BGR decode into Full(), for display.
+    bool DecodeFull(const uint8_t* data, size_t bytes);
+
+    const cv::Mat& Scaled() const { return scaled_; }
+    int Denom() const { return denom_; }
+    const cv::Mat& Full() const { return full_; }
+
+private:
+    struct Impl;
+
+    // input non-empty: denom from ScaleFor() on the header's size, or on
+    // roi clipped to it.
+    bool DecodeInto(const uint8_t* data, size_t bytes, int denom, cv::Size input, const cv::Rect& roi,
+                    cv::Mat& out, int* usedDenom);
+
+    std::unique_ptr<Impl> impl_;
+    cv::Mat scaled_, full_;
+    int denom_ = 1;
+};
@@ -0,0 +1,68 @@
+#include "model_cache.hpp"
+
+#include <opencv2/core.hpp>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+
+// Size and mtime of the model file, as a cheap "has it changed" key.
+bool Fingerprint(const std::string& path, double& bytes, double& mtime) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return false;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return false;
+    bytes = (double)size;
+    mtime = (double)time.time_since_epoch().count();
+    return true;
+}
+
+} // namespace
+
+bool ReadModelCache(const std::string& cachePath, ModelCache& cache) {
+    try {
+        cv::FileStorage fs(cachePath, cv::FileStorage::READ);
+        if (!fs.isOpened())
+            return false;
+        double bytes = 0.0, mtime = 0.0, currentBytes = 0.0, currentMtime = 0.0;
+        fs["model"] >> cache.modelPath;
+        fs["classNames"] >> cache.classNamesPath;
+        fs["backend"] >> cache.backend;
+        fs["optimized"] >> cache.optimizedPath;
+        fs["modelBytes"] >> bytes;
+        fs["modelTime"] >> mtime;
+        fs["loadMs"] >> cache.loadMs;
+        fs["warmupMs"] >> cache.warmupMs;
+        fs["forwardMs"] >> cache.forwardMs;
+        return !cache.modelPath.empty() && Fingerprint(cache.modelPath, currentBytes, currentMtime) &&
+               bytes == currentBytes && mtime == currentMtime;
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
+
+bool WriteModelCache(const std::string& cachePath, const ModelCache& cache) {
+    double bytes = 0.0, mtime = 0.0;
+    if (!Fingerprint(cache.modelPath, bytes, mtime))
+        return false;
+    try {
+        cv::FileStorage fs(cachePath, cv::FileStorage::WRITE);
+        if (!fs.isOpened())
+            return false;
+        fs << "model" << cache.modelPath;
+        fs << "classNames" << cache.classNamesPath;
+        fs << "backend" << cache.backend;
+        fs << "optimized" << cache.optimizedPath;
+        fs << "modelBytes" << bytes;
+        fs << "modelTime" << mtime;
+        fs << "loadMs" << cache.loadMs;
+        fs << "warmupMs" << cache.warmupMs;
+        fs << "forwardMs" << cache.forwardMs;
+        return true;
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+// Startup helpers shared by stream_counter and FishCounter. Warm-up itself
+// is InferenceBackend::Warmup.
+
+// The model / class-names pair that loaded on the previous start, stored as
+// cv::FileStorage YAML with the model's size and mtime, so a restart goes
+// straight to the right file and skips the failing probes. With ONNX Runtime
+// it also names the optimised .ort model that start wrote, which the next
+// one loads instead of parsing and optimising the ONNX again. OpenCV DNN
+// cannot serialise an optimised Net, so with it only the paths are cached.
+// The whole entry becomes stale as soon as the model file changes.
+struct ModelCache {
+    std::string modelPath;
+    std::string classNamesPath;
+    std::string backend;       // BackendKindName of the run that wrote it
+    std::string optimizedPath; // empty = nothing serialised
+    double loadMs = 0.0;
+    double warmupMs = 0.0;
+    double forwardMs = 0.0; // steady-state, from InferenceBackend::Warmup
+};
+
+// False if the cache is missing, unreadable or stale.
+bool ReadModelCache(const std::string& cachePath, ModelCache& cache);
+bool WriteModelCache(const std::string& cachePath, const ModelCache& cache);
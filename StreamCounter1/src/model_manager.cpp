@@ -0,0 +1,69 @@
+#include "model_manager.hpp"
+#include "bench_stats.hpp"
+
+#include <iostream>
+
+ModelManager::~ModelManager() {
+    Wait();
+}
+
+void ModelManager::Start(const Config& config) {
+    Wait();
+    config_ = config;
+    ready_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread(&ModelManager::Run, this);
+}
+
+bool ModelManager::Wait() {
+    if (thread_.joinable())
+        thread_.join();
+    return IsReady();
+}
+
+void ModelManager::Run() {
+    auto start = BenchClock::now();
+    bool loaded = false;
+
+    // Only default locations are cached; explicit --model / --names win
+    ModelCache cached;
+    const bool defaultPaths = config_.detector.modelPath.empty() && config_.detector.classNamesPath.empty();
+    DetectorConfig detector = config_.detector;
+    if (defaultPaths && !config_.cachePath.empty())
+        detector.optimizedModelPath = config_.optimizedPath;
+    cacheHit_ = defaultPaths && ReadModelCache(config_.cachePath, cached);
+    optimizedHit_ = false;
+    if (cacheHit_) {
+        DetectorConfig hit = detector;
+        hit.modelPath = cached.modelPath;
+        hit.classNamesPath = cached.classNamesPath;
+        // Only reuse what this backend wrote for this model
+        hit.reuseOptimizedModel = !cached.optimizedPath.empty() &&
+                                  cached.optimizedPath == detector.optimizedModelPath &&
+                                  cached.backend == BackendKindName(detector.backend);
+        loaded = detector_.Load(hit);
+        cacheHit_ = loaded;
+        optimizedHit_ = loaded && detector_.Backend().LoadedOptimized();
+    }
+    if (!loaded)
+        loaded = LoadDetectorFromDefaultPaths(detector_, detector);
+    stats_.loadMs = MsSince(start);
+    if (!loaded)
+        return;
+
+    start = BenchClock::now();
+    try {
+        stats_.forwardMs = detector_.Backend().Warmup(config_.warmupRuns);
+    } catch (const std::exception& e) {
+        std::cerr << "[YOLO] Warm-up failed: " << e.what() << "\n";
+        return;
+    }
+    stats_.warmupMs = MsSince(start);
+
+    stats_.modelPath = detector_.Config().modelPath;
+    stats_.classNamesPath = detector_.Config().classNamesPath;
+    stats_.backend = BackendKindName(config_.detector.backend);
+    stats_.optimizedPath = detector_.Backend().OptimizedCache();
+    if (defaultPaths && !config_.cachePath.empty())
+        WriteModelCache(config_.cachePath, stats_);
+    ready_.store(true, std::memory_order_release);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "model_cache.hpp"
+#include "yolo_detector.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Loads and warms a YoloDetector on a background thread so the caller can
+// open cameras in the meantime. A valid model cache (see model_cache.hpp)
+// short-circuits the AIStuff/ path probing and, with ONNX Runtime, loads
+// the optimised model saved to optimizedPath on the previous start. Call
+// Wait() before using Detector().
+class ModelManager {
+public:
+    struct Config {
+        DetectorConfig detector;
+        int warmupRuns = 2;
+        std::string cachePath = "model_cache.yml";
+        std::string optimizedPath = "model_cache.ort"; // empty = don't serialise
+    };
+
+    ~ModelManager();
+
+    void Start(const Config& config);
+
+    // Joins the loader; true if the detector is loaded and warm.
+    bool Wait();
+    bool IsReady() const { return ready_.load(std::memory_order_acquire); }
+
+    YoloDetector& Detector() { return detector_; }
+
+    // Valid after Wait(): this start's load / warm-up / steady forward times.
+    const ModelCache& Stats() const { return stats_; }
+    bool CacheHit() const { return cacheHit_; }
+    // The model came from the serialised optimised copy, not the ONNX.
+    bool OptimizedHit() const { return optimizedHit_; }
+
+private:
+    void Run();
+
+    Config config_;
+    YoloDetector detector_;
+    ModelCache stats_;
+    bool cacheHit_ = false;
+    bool optimizedHit_ = false;
+    std::atomic<bool> ready_{ false };
+    std::thread thread_;
+};
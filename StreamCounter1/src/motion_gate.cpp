@@ -0,0 +1,63 @@
+#include "motion_gate.hpp"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+bool MotionGate::Check(const uint8_t* luma, int stride, int width, int height) {
+    const int factor = std::max(1, config_.downsample);
+    const cv::Size thumbSize(std::max(1, width / factor), std::max(1, height / factor));
+
+    if (reference_.size() != thumbSize) {
+        hasReference_ = false;
+        blocksX_ = thumbSize.width / kBlock;
+        blocksY_ = thumbSize.height / kBlock;
+    }
+
+    // INTER_AREA averages each factor x factor cell, which also suppresses sensor noise
+    cv::Mat src(height, width, CV_8UC1, const_cast<uint8_t*>(luma), stride);
+    cv::resize(src, current_, thumbSize, 0, 0, cv::INTER_AREA);
+
+    bool accept = !hasReference_ || ++framesSinceAccept_ >= config_.maxSkipFrames;
+    if (!accept) {
+        lastChangedBlocks_ = CountChangedBlocks();
+        int needed = std::max(1, (int)(config_.minChangedFraction * TotalBlocks()));
+        accept = lastChangedBlocks_ >= needed;
+    }
+
+    if (!accept) {
+        ++skipped_;
+        return false;
+    }
+
+    cv::swap(current_, reference_);
+    hasReference_ = true;
+    framesSinceAccept_ = 0;
+    return true;
+}
+
+int MotionGate::CountChangedBlocks() const {
+    // Integer threshold on the block SAD, so the inner loop never touches floats
+    const unsigned sadThreshold = (unsigned)(config_.blockThreshold * kBlock * kBlock);
+    int changed = 0;
+
+    for (int by = 0; by < blocksY_; ++by) {
+        for (int bx = 0; bx < blocksX_; ++bx) {
+            unsigned sad = 0;
+            for (int r = 0; r < kBlock; ++r) {
+                const uint8_t* a = current_.ptr<uint8_t>(by * kBlock + r) + bx * kBlock;
+                const uint8_t* b = reference_.ptr<uint8_t>(by * kBlock + r) + bx * kBlock;
+#if CV_SIMD128
+                sad += cv::v_reduce_sad(cv::v_load(a), cv::v_load(b));
+#else
+                for (int x = 0; x < kBlock; ++x)
+                    sad += (unsigned)std::abs(a[x] - b[x]);
+#endif
+            }
+            if (sad > sadThreshold)
+                ++changed;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+
+// Cheap scene-change detector that decides whether a frame is worth a YOLO
+// forward pass. The luma plane (NV12 Y plane, or any 8-bit grey image) is
+// area-downsampled into a small persistent image and compared block by
+// block (16x16, SIMD SAD) against the reference taken at the last accepted
+// frame. Comparing against the last inferred frame rather than the previous
+// frame means slow movement still accumulates into a trigger.
+class MotionGate {
+public:
+    struct Config {
+        int downsample = 4;             // source pixels per thumbnail pixel
+        float blockThreshold = 10.f;    // mean |diff| per pixel for a changed block
+        float minChangedFraction = 0.01f;
+        int maxSkipFrames = 300;        // force a refresh after this many gated frames
+    };
+
+    MotionGate() : MotionGate(Config()) {}
+    explicit MotionGate(const Config& config) : config_(config) {}
+
+    // Returns true when the frame differs enough from the reference (or no
+    // reference exists yet, or maxSkipFrames was reached). On true the frame
+    // becomes the new reference; on false the caller should reuse its last result.
+    bool Check(const uint8_t* luma, int stride, int width, int height);
+
+    void Reset() { hasReference_ = false; }
+
+    int LastChangedBlocks() const { return lastChangedBlocks_; }
+    int TotalBlocks() const { return blocksX_ * blocksY_; }
+    uint64_t SkippedFrames() const { return skipped_; }
+
+private:
+    static constexpr int kBlock = 16;
+
+    int CountChangedBlocks() const;
+
+    Config config_;
+    cv::Mat current_;
+    cv::Mat reference_;
+    int blocksX_ = 0;
+    int blocksY_ = 0;
+    bool hasReference_ = false;
+    int framesSinceAccept_ = 0;
+    int lastChangedBlocks_ = 0;
+    uint64_t skipped_ = 0;
+};
@@ -0,0 +1,206 @@
+#include "nms.hpp"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+// Below this a single cell (a plain SIMD scan of the kept boxes) is faster
+constexpr int kMinGridCandidates = 48;
+
+// A little below the threshold, so the float pre-test never rejects a pair
+// that the exact test would suppress
+inline float LooseThreshold(float iouThreshold) {
+    return iouThreshold * (1.f - 1e-5f);
+}
+
+// IoU > threshold, computed like OpenCV's rectOverlap (1 - Jaccard distance
+// in double) so threshold ties resolve the same way. The division only runs
+// for pairs near or above the threshold.
+inline bool Overlaps(float inter, float uni, float looseThreshold, float iouThreshold) {
+    if (inter <= 0.f || inter <= looseThreshold * uni)
+        return false;
+    return 1.f - (float)(1.0 - (double)inter / uni) > iouThreshold;
+}
+
+// Sorts ascending as score descending, then index ascending (NMSBoxes'
+// stable order), and compares as one integer
+inline uint64_t RankKey(float score, int index) {
+    uint32_t bits;
+    std::memcpy(&bits, &score, sizeof(bits));
+    bits ^= (bits >> 31) ? 0xffffffffu : 0x80000000u; // total order as unsigned
+    return ((uint64_t)~bits << 32) | (uint32_t)index;
+}
+
+} // namespace
+
+void Nms::Select(const std::vector<float>& scores, const int* classIds, int n,
+                 float scoreThreshold) {
+    ranked_.clear();
+    for (int i = 0; i < n; ++i) {
+        if (scores[i] > scoreThreshold)
+            ranked_.push_back({ classIds ? classIds[i] : 0, RankKey(scores[i], i) });
+    }
+    auto better = [](const Ranked& a, const Ranked& b) { return a.key < b.key; };
+    if (topK_ > 0 && (int)ranked_.size() > topK_) {
+        std::nth_element(ranked_.begin(), ranked_.begin() + topK_, ranked_.end(), better);
+        ranked_.resize(topK_);
+    }
+    std::sort(ranked_.begin(), ranked_.end(), [](const Ranked& a, const Ranked& b) {
+        return a.group < b.group || (a.group == b.group && a.key < b.key);
+    });
+    order_.resize(ranked_.size());
+    for (size_t r = 0; r < ranked_.size(); ++r)
+        order_[r] = (int)(uint32_t)ranked_[r].key;
+}
+
+void Nms::Run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+              float scoreThreshold, float iouThreshold, std::vector<int>& keep) {
+    keep.clear();
+    Select(scores, nullptr, (int)std::min(boxes.size(), scores.size()), scoreThreshold);
+    RunGroup(boxes, 0, (int)order_.size(), iouThreshold, keep);
+}
+
+void Nms::Run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+              const std::vector<int>& classIds, float scoreThreshold, float iouThreshold,
+              std::vector<int>& keep) {
+    keep.clear();
+    const int n = (int)std::min({ boxes.size(), scores.size(), classIds.size() });
+    Select(scores, classIds.data(), n, scoreThreshold);
+
+    const int count = (int)order_.size();
+    for (int begin = 0; begin < count;) {
+        int end = begin + 1;
+        while (end < count && ranked_[end].group == ranked_[begin].group)
+            ++end;
+        RunGroup(boxes, begin, end, iouThreshold, keep);
+        begin = end;
+    }
+    // Back to one score order across classes
+    std::sort(keep.begin(), keep.end(),
+              [&](int a, int b) { return RankKey(scores[a], a) < RankKey(scores[b], b); });
+}
+
+void Nms::RunGroup(const std::vector<cv::Rect>& boxes, int begin, int end, float iouThreshold,
+                   std::vector<int>& keep) {
+    const int m = end - begin;
+    if (m <= 0)
+        return;
+
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN, maxSide = 1;
+    for (int r = 0; r < m; ++r) {
+        const cv::Rect& b = boxes[order_[begin + r]];
+        minX = std::min(minX, b.x);
+        minY = std::min(minY, b.y);
+        maxX = std::max(maxX, b.x);
+        maxY = std::max(maxY, b.y);
+        maxSide = std::max({ maxSide, b.width, b.height });
+    }
+
+    // A box only overlaps boxes whose top-left lies in its own or an adjacent
+    // cell as long as the cell is at least the largest side. Coarser cells
+    // stay correct, so grow them until there are about two candidates each.
+    long long cell = maxSide;
+    gridW_ = gridH_ = 1;
+    if (m >= kMinGridCandidates) {
+        const long long maxCells = m / 2;
+        while (true) {
+            const long long w = ((long long)maxX - minX) / cell + 1;
+            const long long h = ((long long)maxY - minY) / cell + 1;
+            if (w * h <= maxCells) {
+                gridW_ = (int)w;
+                gridH_ = (int)h;
+                break;
+            }
+            cell *= 2;
+        }
+    }
+
+    // Each cell gets room for all of its candidates; only kept boxes are
+    // written there, so tests scan kept boxes only, in score order
+    const int cells = gridW_ * gridH_;
+    cellStart_.assign(cells + 1, 0);
+    cellKept_.assign(cells, 0);
+    cellOf_.resize(m);
+    for (int r = 0; r < m; ++r) {
+        const cv::Rect& b = boxes[order_[begin + r]];
+        const int cx = gridW_ > 1 ? (int)((b.x - (long long)minX) / cell) : 0;
+        const int cy = gridH_ > 1 ? (int)((b.y - (long long)minY) / cell) : 0;
+        cellOf_[r] = cy * gridW_ + cx;
+        ++cellStart_[cellOf_[r] + 1];
+    }
+    for (int c = 0; c < cells; ++c)
+        cellStart_[c + 1] += cellStart_[c];
+
+    x1_.resize(m);
+    y1_.resize(m);
+    x2_.resize(m);
+    y2_.resize(m);
+    area_.resize(m);
+    for (int r = 0; r < m; ++r) {
+        const int idx = order_[begin + r];
+        const cv::Rect& b = boxes[idx];
+        const float x1 = (float)b.x, y1 = (float)b.y;
+        const float x2 = x1 + b.width, y2 = y1 + b.height;
+        const float area = (float)b.width * b.height;
+        const int c = cellOf_[r];
+        if (Suppressed(x1, y1, x2, y2, area, c % gridW_, c / gridW_, iouThreshold))
+            continue;
+        const int slot = cellStart_[c] + cellKept_[c]++;
+        x1_[slot] = x1;
+        y1_[slot] = y1;
+        x2_[slot] = x2;
+        y2_[slot] = y2;
+        area_[slot] = area;
+        keep.push_back(idx);
+    }
+}
+
+bool Nms::Suppressed(float ax1, float ay1, float ax2, float ay2, float aArea, int cellX, int cellY,
+                     float iouThreshold) const {
+    const float loose = LooseThreshold(iouThreshold);
+    auto overlaps = [&](int j) {
+        const float iw = std::max(0.f, std::min(ax2, x2_[j]) - std::max(ax1, x1_[j]));
+        const float ih = std::max(0.f, std::min(ay2, y2_[j]) - std::max(ay1, y1_[j]));
+        const float inter = iw * ih;
+        return Overlaps(inter, aArea + area_[j] - inter, loose, iouThreshold);
+    };
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 zero = cv::vx_setzero_f32();
+    const cv::v_float32 vx1 = cv::vx_setall_f32(ax1), vy1 = cv::vx_setall_f32(ay1);
+    const cv::v_float32 vx2 = cv::vx_setall_f32(ax2), vy2 = cv::vx_setall_f32(ay2);
+    const cv::v_float32 varea = cv::vx_setall_f32(aArea);
+    const cv::v_float32 vthr = cv::vx_setall_f32(loose);
+#endif
+
+    for (int y = std::max(0, cellY - 1); y <= std::min(gridH_ - 1, cellY + 1); ++y) {
+        for (int x = std::max(0, cellX - 1); x <= std::min(gridW_ - 1, cellX + 1); ++x) {
+            const int c = y * gridW_ + x;
+            int j = cellStart_[c];
+            const int e = j + cellKept_[c];
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+            for (; j <= e - lanes; j += lanes) {
+                cv::v_float32 iw = cv::v_sub(cv::v_min(vx2, cv::vx_load(&x2_[j])), cv::v_max(vx1, cv::vx_load(&x1_[j])));
+                cv::v_float32 ih = cv::v_sub(cv::v_min(vy2, cv::vx_load(&y2_[j])), cv::v_max(vy1, cv::vx_load(&y1_[j])));
+                cv::v_float32 inter = cv::v_mul(cv::v_max(iw, zero), cv::v_max(ih, zero));
+                cv::v_float32 uni = cv::v_sub(cv::v_add(varea, cv::vx_load(&area_[j])), inter);
+                if (cv::v_check_any(cv::v_gt(inter, cv::v_mul(vthr, uni)))) {
+                    for (int k = j; k < j + lanes; ++k) {
+                        if (overlaps(k))
+                            return true;
+                    }
+                }
+            }
+#endif
+            for (; j < e; ++j) {
+                if (overlaps(j))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// Greedy, score-sorted non-maximum suppression with the same results as
+// cv::dnn::NMSBoxes / NMSBoxesBatched: candidates above scoreThreshold are
+// visited best-first (ties by index) and dropped if their IoU with an
+// already kept box exceeds iouThreshold (in [0, 1)).
+//
+// Instead of testing every kept box, kept boxes are bucketed on a uniform
+// grid whose cell is at least the largest box side, so only the 3 x 3 cells
+// around a candidate can overlap it. Boxes are float SoA per cell and IoU is
+// tested with SIMD, a whole cell at a time. With a top-K cap only the K best
+// candidates are sorted and visited. Scratch buffers are members and keep
+// their capacity, so steady-state calls do not allocate. Not thread-safe;
+// one per thread.
+class Nms {
+public:
+    // Candidates kept after the score sort, 0 = all (NMSBoxes' top_k).
+    explicit Nms(int topK = 0) : topK_(topK) {}
+    void SetTopK(int topK) { topK_ = topK; }
+    int TopK() const { return topK_; }
+
+    // Class-agnostic, like cv::dnn::NMSBoxes. keep is in score order.
+    void Run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+             float scoreThreshold, float iouThreshold, std::vector<int>& keep);
+
+    // A box only suppresses boxes of its own class, like
+    // cv::dnn::NMSBoxesBatched. keep is in score order.
+    void Run(const std::vector<cv::Rect>& boxes, const std::vector<float>& scores,
+             const std::vector<int>& classIds, float scoreThreshold, float iouThreshold,
+             std::vector<int>& keep);
+
+private:
+    // Candidates above scoreThreshold, top-K cut, sorted by group (class, or
+    // 0 when classIds is null) then score, into ranked_ / order_.
+    void Select(const std::vector<float>& scores, const int* classIds, int n, float scoreThreshold);
+    // Suppresses within order_[begin, end), which is in score order.
+    void RunGroup(const std::vector<cv::Rect>& boxes, int begin, int end, float iouThreshold,
+                  std::vector<int>& keep);
+    bool Suppressed(float x1, float y1, float x2, float y2, float area, int cellX, int cellY,
+                    float iouThreshold) const;
+
+    struct Ranked {
+        int group;
+        uint64_t key; // score descending, then index
+    };
+
+    int topK_;
+    std::vector<Ranked> ranked_;
+    std::vector<int> order_; // box index per rank
+
+    // Grid of the current group. Cell c owns slots [cellStart_[c],
+    // cellStart_[c + 1]), of which the first cellKept_[c] hold kept boxes.
+    int gridW_ = 0, gridH_ = 0;
+    std::vector<int> cellStart_;
+    std::vector<int> cellKept_;
+    std::vector<int> cellOf_; // per rank
+    std::vector<float> x1_, y1_, x2_, y2_, area_;
+};
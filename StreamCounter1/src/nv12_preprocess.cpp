@@ -0,0 +1,137 @@
+#include "nv12_preprocess.hpp"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+
+namespace {
+
+// BT.601 limited range (matches cv::COLOR_YUV2BGR_NV12), pre-divided by 255
+constexpr float kY = 1.164f / 255.f;
+constexpr float kRV = 1.596f / 255.f;
+constexpr float kGU = 0.391f / 255.f;
+constexpr float kGV = 0.813f / 255.f;
+constexpr float kBU = 2.018f / 255.f;
+
+// Converts one row of sampled Y/U/V to normalised R, G, B planes.
+void ConvertRow(const float* y, const float* u, const float* v,
+                float* r, float* g, float* b, int width) {
+    int x = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 v16 = cv::vx_setall_f32(16.f), v128 = cv::vx_setall_f32(128.f);
+    const cv::v_float32 vkY = cv::vx_setall_f32(kY), vkRV = cv::vx_setall_f32(kRV);
+    const cv::v_float32 vkGU = cv::vx_setall_f32(kGU), vkGV = cv::vx_setall_f32(kGV);
+    const cv::v_float32 vkBU = cv::vx_setall_f32(kBU);
+    const cv::v_float32 zero = cv::vx_setzero_f32(), one = cv::vx_setall_f32(1.f);
+    for (; x <= width - lanes; x += lanes) {
+        cv::v_float32 yy = cv::v_mul(cv::v_sub(cv::vx_load(y + x), v16), vkY);
+        cv::v_float32 uu = cv::v_sub(cv::vx_load(u + x), v128);
+        cv::v_float32 vv = cv::v_sub(cv::vx_load(v + x), v128);
+        cv::v_float32 rr = cv::v_fma(vv, vkRV, yy);
+        cv::v_float32 gg = cv::v_sub(yy, cv::v_add(cv::v_mul(vv, vkGV), cv::v_mul(uu, vkGU)));
+        cv::v_float32 bb = cv::v_fma(uu, vkBU, yy);
+        cv::v_store(r + x, cv::v_min(cv::v_max(rr, zero), one));
+        cv::v_store(g + x, cv::v_min(cv::v_max(gg, zero), one));
+        cv::v_store(b + x, cv::v_min(cv::v_max(bb, zero), one));
+    }
+#endif
+    for (; x < width; ++x) {
+        float yy = (y[x] - 16.f) * kY;
+        float uu = u[x] - 128.f;
+        float vv = v[x] - 128.f;
+        r[x] = std::min(std::max(yy + kRV * vv, 0.f), 1.f);
+        g[x] = std::min(std::max(yy - kGV * vv - kGU * uu, 0.f), 1.f);
+        b[x] = std::min(std::max(yy + kBU * uu, 0.f), 1.f);
+    }
+}
+
+// Bilinear source taps for every inner output coordinate, pixel-centre aligned
+// like cv::resize(INTER_LINEAR).
+void BuildAxis(int innerSize, int srcSize, float scale,
+               std::vector<int>& i0, std::vector<int>& i1, std::vector<float>& frac,
+               std::vector<int>& chroma) {
+    i0.resize(innerSize);
+    i1.resize(innerSize);
+    frac.resize(innerSize);
+    chroma.resize(innerSize);
+    for (int d = 0; d < innerSize; ++d) {
+        float s = (d + 0.5f) / scale - 0.5f;
+        s = std::min(std::max(s, 0.f), (float)(srcSize - 1));
+        int s0 = (int)s;
+        i0[d] = s0;
+        i1[d] = std::min(s0 + 1, srcSize - 1);
+        frac[d] = s - s0;
+        chroma[d] = std::min((int)((d + 0.5f) / scale), srcSize - 1) >> 1;
+    }
+}
+
+} // namespace
+
+void Nv12Preprocessor::Configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight) {
+    if (!blob_.empty() && geometry_.srcWidth == srcWidth && geometry_.srcHeight == srcHeight &&
+        geometry_.dstWidth == dstWidth && geometry_.dstHeight == dstHeight)
+        return;
+
+    geometry_ = ComputeLetterbox(srcWidth, srcHeight, dstWidth, dstHeight);
+
+    const int blobShape[] = { 1, 3, dstHeight, dstWidth };
+    blob_.create(4, blobShape, CV_32F);
+    blob_.setTo(cv::Scalar::all(kLetterboxPadValue));
+
+    BuildAxis(geometry_.innerWidth, srcWidth, geometry_.scale, x0_, x1_, fx_, chromaX_);
+    BuildAxis(geometry_.innerHeight, srcHeight, geometry_.scale, y0_, y1_, fy_, chromaY_);
+    for (int& cx : chromaX_)
+        cx *= 2; // byte offset of the interleaved U,V pair
+
+    rowY_.resize(geometry_.innerWidth);
+    rowU_.resize(geometry_.innerWidth);
+    rowV_.resize(geometry_.innerWidth);
+}
+
+void Nv12Preprocessor::Run(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane, int uvStride) {
+    // Padding of blob_ was written once in Configure
+    ConvertInner(yPlane, yStride, uvPlane, uvStride, blob_.ptr<float>());
+}
+
+void Nv12Preprocessor::RunInto(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane,
+                               int uvStride, float* planes) {
+    FillLetterboxPadding(planes, geometry_);
+    ConvertInner(yPlane, yStride, uvPlane, uvStride, planes);
+}
+
+void Nv12Preprocessor::ConvertInner(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane,
+                                    int uvStride, float* planes) {
+    const int innerW = geometry_.innerWidth;
+    const int dstW = geometry_.dstWidth;
+    const size_t planeSize = (size_t)dstW * geometry_.dstHeight;
+
+    float* rPlane = planes;
+    float* gPlane = rPlane + planeSize;
+    float* bPlane = gPlane + planeSize;
+
+    const int* x0 = x0_.data();
+    const int* x1 = x1_.data();
+    const float* fx = fx_.data();
+    const int* cx = chromaX_.data();
+    float* rowY = rowY_.data();
+    float* rowU = rowU_.data();
+    float* rowV = rowV_.data();
+
+    for (int y = 0; y < geometry_.innerHeight; ++y) {
+        const uint8_t* top = yPlane + (size_t)y0_[y] * yStride;
+        const uint8_t* bottom = yPlane + (size_t)y1_[y] * yStride;
+        const uint8_t* uv = uvPlane + (size_t)chromaY_[y] * uvStride;
+        const float fy = fy_[y];
+
+        for (int x = 0; x < innerW; ++x) {
+            float t = top[x0[x]] + (top[x1[x]] - top[x0[x]]) * fx[x];
+            float b = bottom[x0[x]] + (bottom[x1[x]] - bottom[x0[x]]) * fx[x];
+            rowY[x] = t + (b - t) * fy;
+            rowU[x] = uv[cx[x]];
+            rowV[x] = uv[cx[x] + 1];
+        }
+
+        const size_t offset = (size_t)(geometry_.padY + y) * dstW + geometry_.padX;
+        ConvertRow(rowY, rowU, rowV, rPlane + offset, gPlane + offset, bPlane + offset, innerW);
+    }
+}
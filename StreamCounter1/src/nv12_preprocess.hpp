@@ -0,0 +1,78 @@
+#pragma once
+
+#include "letterbox.hpp"
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Clamps an inference ROI to the frame and rounds it outwards to even
+// coordinates, so an NV12 sub-window starts on a chroma pair. An empty roi
+// selects the whole frame.
+inline cv::Rect AlignNv12Roi(const cv::Rect& roi, int width, int height) {
+    if (roi.empty())
+        return cv::Rect(0, 0, width, height);
+    const int x0 = std::max(0, roi.x) & ~1;
+    const int y0 = std::max(0, roi.y) & ~1;
+    const int x1 = std::min(width, (roi.x + roi.width + 1) & ~1);
+    const int y1 = std::min(height, (roi.y + roi.height + 1) & ~1);
+    if (x1 <= x0 || y1 <= y0)
+        return cv::Rect(0, 0, width, height);
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// Plane pointers of an NV12 sub-window; strides are unchanged.
+inline void OffsetNv12Planes(const cv::Rect& roi, const uint8_t*& yPlane, int yStride,
+                             const uint8_t*& uvPlane, int uvStride) {
+    yPlane += (size_t)roi.y * yStride + roi.x;
+    uvPlane += (size_t)(roi.y / 2) * uvStride + roi.x;
+}
+
+// Fused NV12 -> letterboxed, normalised RGB planar float blob.
+//
+// Replaces cvtColor(COLOR_YUV2BGR_NV12) + blobFromImage(swapRB, 1/255):
+// each output pixel bilinearly samples the Y plane, takes the nearest
+// chroma pair, converts with BT.601 limited-range coefficients (same as
+// cvtColor) and is written straight into the R, G and B planes. The
+// source planes are read in place, so callers can pass a locked
+// IMFMediaBuffer or a V4L2 mmap buffer directly. The blob and sampling
+// tables persist across frames; padding is filled only on Configure.
+class Nv12Preprocessor {
+public:
+    // Rebuilds tables and blob only when the geometry changes.
+    void Configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+    void Run(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane, int uvStride);
+
+    // Contiguous NV12 (UV plane directly after Y, same stride).
+    void Run(const uint8_t* nv12, int stride) {
+        Run(nv12, stride, nv12 + (size_t)stride * geometry_.srcHeight, stride);
+    }
+
+    // Writes the full letterboxed image, padding included, to external planes
+    // (3 x dstHeight x dstWidth floats), e.g. one slice of a batched blob.
+    void RunInto(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane, int uvStride,
+                 float* planes);
+
+    // 1 x 3 x dstHeight x dstWidth, CV_32F, RGB order.
+    const cv::Mat& Blob() const { return blob_; }
+    const LetterboxGeometry& Geometry() const { return geometry_; }
+    BoxTransform Transform() const { return geometry_.ToBoxTransform(); }
+
+private:
+    void ConvertInner(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane, int uvStride,
+                      float* planes);
+
+    LetterboxGeometry geometry_;
+    cv::Mat blob_;
+
+    // Per output column / row sampling tables (inner region only)
+    std::vector<int> x0_, x1_, chromaX_;
+    std::vector<float> fx_;
+    std::vector<int> y0_, y1_, chromaY_;
+    std::vector<float> fy_;
+
+    // Row scratch: sampled Y, U, V for one output row
+    std::vector<float> rowY_, rowU_, rowV_;
+};
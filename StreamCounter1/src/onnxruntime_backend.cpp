@@ -0,0 +1,211 @@
+#include "inference_backend.hpp"
+
+#ifdef HAVE_ONNXRUNTIME
+
+#include <onnxruntime_cxx_api.h>
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// ONNX Runtime CPU execution provider with IO binding. Compiled only with
+// HAVE_ONNXRUNTIME: CMake sets it when it finds onnxruntime, FishCounter.vcxproj
+// when $(OnnxRuntimeDir) holds an onnxruntime release.
+//
+// Input and output tensors are bound once per batch size to buffers owned by
+// the backend, so Forward() is a single Session::Run with no per-frame
+// tensor creation or output allocation. Outputs with dynamic dims other than
+// the batch are left to ORT to allocate and are read back after the run.
+
+namespace {
+
+class OnnxRuntimeBackend : public InferenceBackend {
+public:
+    const char* Name() const override { return "onnxruntime"; }
+    bool Load(const std::string& modelPath, cv::Size inputSize) override;
+    float* InputBuffer(int batch) override;
+    void Forward(int batch) override;
+    TensorView Output(int index = 0) const override;
+
+private:
+    // Tensors and binding for one batch size; they point into input_ and
+    // storage, so they are rebuilt if input_ reallocates.
+    struct Binding {
+        std::unique_ptr<Ort::IoBinding> io;
+        Ort::Value input{ nullptr };
+        std::vector<Ort::Value> outputs;           // bound, static shape
+        std::vector<std::vector<float>> storage;   // backing for outputs
+        std::vector<std::vector<int64_t>> shapes;  // per output; empty = ORT-allocated
+        bool dynamic = false;                      // some output is ORT-allocated
+    };
+
+    Binding& BindingFor(int batch);
+
+    Ort::Env env_{ ORT_LOGGING_LEVEL_WARNING, "StreamCounter" };
+    std::unique_ptr<Ort::Session> session_;
+    Ort::MemoryInfo memory_ = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    std::string inputName_;
+    std::vector<std::string> outputNames_;
+    std::vector<std::vector<int64_t>> outputShapes_; // from the model, -1 = dynamic
+    std::vector<float> input_;                       // capacity x 3 x H x W
+    std::vector<std::unique_ptr<Binding>> bindings_; // indexed by batch size
+    const Binding* current_ = nullptr;               // last run
+    std::vector<Ort::Value> results_;                // last run's outputs, if dynamic
+};
+
+bool OnnxRuntimeBackend::Load(const std::string& modelPath, cv::Size inputSize) {
+    optimizedCache_.clear();
+    loadedOptimized_ = false;
+    session_.reset();
+    auto toOrt = [](const std::string& path) { return std::basic_string<ORTCHAR_T>(path.begin(), path.end()); };
+    const int threads = threads_ > 0 ? threads_ : (int)std::max(1u, std::thread::hardware_concurrency());
+
+    // Optimised ORT-format model from an earlier start: no parse, no passes
+    if (reuseOptimized_ && !optimizedPath_.empty()) {
+        try {
+            Ort::SessionOptions options;
+            options.SetIntraOpNumThreads(threads);
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_DISABLE_ALL);
+            session_ = std::make_unique<Ort::Session>(env_, toOrt(optimizedPath_).c_str(), options);
+            optimizedCache_ = optimizedPath_;
+            loadedOptimized_ = true;
+        } catch (const std::exception& e) {
+            std::cerr << "[YOLO] Cached optimised model unusable, loading the ONNX: " << e.what() << "\n";
+            session_.reset();
+        }
+    }
+
+    try {
+        if (!session_) {
+            Ort::SessionOptions options;
+            options.SetIntraOpNumThreads(threads);
+            options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+            if (!optimizedPath_.empty()) {
+                options.SetOptimizedModelFilePath(toOrt(optimizedPath_).c_str());
+                options.AddConfigEntry("session.save_model_format", "ORT");
+            }
+            session_ = std::make_unique<Ort::Session>(env_, toOrt(modelPath).c_str(), options);
+            optimizedCache_ = optimizedPath_;
+        }
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        inputName_ = session_->GetInputNameAllocated(0, allocator).get();
+        outputNames_.clear();
+        outputShapes_.clear();
+        for (size_t i = 0; i < session_->GetOutputCount(); ++i) {
+            outputNames_.push_back(session_->GetOutputNameAllocated(i, allocator).get());
+            outputShapes_.push_back(
+                session_->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
+        }
+    } catch (const Ort::Exception& e) {
+        std::cerr << "[YOLO] ONNX Runtime: " << e.what() << "\n";
+        session_.reset();
+        optimizedCache_.clear();
+        return false;
+    } catch (const std::exception& e) { // bad_alloc, std::string copies of the names
+        std::cerr << "[YOLO] ONNX Runtime load failed: " << e.what() << "\n";
+        session_.reset();
+        optimizedCache_.clear();
+        return false;
+    }
+    inputSize_ = inputSize;
+    input_.clear();
+    bindings_.clear();
+    current_ = nullptr;
+    results_.clear();
+    return true;
+}
+
+float* OnnxRuntimeBackend::InputBuffer(int batch) {
+    const size_t needed = (size_t)batch * 3 * inputSize_.area();
+    if (input_.size() < needed) {
+        input_.resize(needed);
+        bindings_.clear(); // bound tensors pointed at the old buffer
+        current_ = nullptr;
+    }
+    return input_.data();
+}
+
+OnnxRuntimeBackend::Binding& OnnxRuntimeBackend::BindingFor(int batch) {
+    if ((int)bindings_.size() <= batch)
+        bindings_.resize(batch + 1);
+    std::unique_ptr<Binding>& slot = bindings_[batch];
+    if (slot)
+        return *slot;
+
+    slot = std::make_unique<Binding>();
+    Binding& b = *slot;
+    b.io = std::make_unique<Ort::IoBinding>(*session_);
+
+    const int64_t inputShape[] = { batch, 3, inputSize_.height, inputSize_.width };
+    b.input = Ort::Value::CreateTensor<float>(memory_, input_.data(),
+                                              (size_t)batch * 3 * inputSize_.area(), inputShape, 4);
+    b.io->BindInput(inputName_.c_str(), b.input);
+
+    b.storage.resize(outputNames_.size());
+    b.shapes.resize(outputNames_.size());
+    for (size_t i = 0; i < outputNames_.size(); ++i) {
+        std::vector<int64_t> shape = outputShapes_[i];
+        if (!shape.empty() && shape[0] < 0)
+            shape[0] = batch;
+        const bool fixed = !shape.empty() &&
+                           std::all_of(shape.begin(), shape.end(), [](int64_t d) { return d > 0; });
+        if (!fixed) {
+            b.io->BindOutput(outputNames_[i].c_str(), memory_);
+            b.dynamic = true;
+            continue;
+        }
+        size_t count = 1;
+        for (int64_t d : shape)
+            count *= (size_t)d;
+        b.storage[i].resize(count);
+        b.shapes[i] = shape;
+        b.outputs.push_back(Ort::Value::CreateTensor<float>(memory_, b.storage[i].data(), count,
+                                                            shape.data(), shape.size()));
+        b.io->BindOutput(outputNames_[i].c_str(), b.outputs.back());
+    }
+    return b;
+}
+
+void OnnxRuntimeBackend::Forward(int batch) {
+    if (!session_)
+        throw std::runtime_error("ONNX Runtime backend not loaded");
+    InputBuffer(batch);
+    Binding& b = BindingFor(batch);
+    session_->Run(Ort::RunOptions{ nullptr }, *b.io);
+    current_ = &b;
+    if (b.dynamic)
+        results_ = b.io->GetOutputValues();
+}
+
+TensorView OnnxRuntimeBackend::Output(int index) const {
+    TensorView view;
+    if (!current_ || index >= (int)outputNames_.size())
+        return view;
+    if (!current_->dynamic) {
+        const std::vector<int64_t>& shape = current_->shapes[index];
+        view.data = current_->storage[index].data();
+        view.dims = (int)std::min<size_t>(shape.size(), 4);
+        for (int d = 0; d < view.dims; ++d)
+            view.shape[d] = (int)shape[d];
+        return view;
+    }
+    if (index >= (int)results_.size())
+        return view;
+    const Ort::Value& value = results_[index];
+    const std::vector<int64_t> shape = value.GetTensorTypeAndShapeInfo().GetShape();
+    view.data = value.GetTensorData<float>();
+    view.dims = (int)std::min<size_t>(shape.size(), 4);
+    for (int d = 0; d < view.dims; ++d)
+        view.shape[d] = (int)shape[d];
+    return view;
+}
+
+} // namespace
+
+std::unique_ptr<InferenceBackend> CreateOnnxRuntimeBackend() {
+    return std::make_unique<OnnxRuntimeBackend>();
+}
+
+#endif // HAVE_ONNXRUNTIME
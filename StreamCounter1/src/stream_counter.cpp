@@ -0,0 +1,829 @@
+#include "bench_stats.hpp"
+#include "byte_tracker.hpp"
+#include "flow_propagator.hpp"
+#include "inference_batcher.hpp"
+#include "inference_pool.hpp"
+#include "line_counter.hpp"
+#include "model_manager.hpp"
+#include "mjpeg_decoder.hpp"
+#include "motion_gate.hpp"
+#include "v4l2_capture.hpp"
+#include "yolo_detector.hpp"
+#include "zone_counter.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless detect-and-count loop for Linux inference boxes.
+//
+//   stream_counter [source...] [--model PATH] [--names PATH] [--input-size [N:]WxH]...
+//                  [--frames N] [--report-every N] [--motion-gate] [--infer-every N] [--flow]
+//                  [--batch N] [--max-wait-ms X] [--int8] [--roi x,y,w,h]...
+//                  [--backend opencv|ort] [--pool M] [--threads K] [--pin]
+//                  [--classes NAME,...] [--count-class NAME] [--agnostic-nms]
+//                  [--line [N:]x1,y1,x2,y2]...
+//                  [--zone [N:]x1,y1,x2,y2,x3,y3,...]... [--v4l2 WxH [--mjpeg]]
+//
+// --motion-gate skips inference (reusing the last count) on frames whose luma
+// has not changed since the last inferred frame (single-source mode); the
+// tracker then only advances its Kalman predictions.
+// --infer-every N runs the model on every N-th frame only (single-source
+// mode); in between, tracks are Kalman-predicted or, with --flow, moved by
+// Lucas-Kanade optical flow from points seeded in each box (see
+// bench_interval for the accuracy / CPU trade-off).
+// --v4l2 captures the device source at WxH NV12 through V4L2Capture
+// (single-source mode): inference, the motion gate and flow read the mmap'd
+// driver buffer in place instead of a BGR copy (see bench_capture). Linux only.
+// --mjpeg captures MJPEG instead, for cameras that only deliver large sizes
+// compressed: frames are decoded only when inference runs, at the smallest
+// DCT scale that still covers the input size (see bench_mjpeg). Needs a
+// build with libjpeg-turbo; not with --flow.
+// source is a V4L2 device index (default 0) or a video file such as Video.mp4.
+// With several sources, or --batch > 1, every source gets a capture thread and
+// their latest frames are forwarded together through an InferenceBatcher
+// (up to --batch frames per forward, waiting at most --max-wait-ms).
+// --int8 runs the quantised model (see calibrate_int8).
+// --backend picks the inference runtime; ort needs a build with ONNX Runtime.
+// --pool serves the sources from M independent model instances (0 = one per
+// K cores) with --threads K intra-op threads each, optionally --pin'ned to
+// their own cores, instead of the batcher.
+// --classes limits decoding and NMS to the named coco.names classes.
+// --count-class names the class that is counted (default person, or the
+// first of --classes when person is not among them).
+// NMS runs per class; --agnostic-nms lets any class suppress any other.
+// Counts come from a ByteTracker per source: "present" is the tracked objects
+// of the count class in view, "unique" how many have passed through.
+// --line adds a directional counting line (frame pixels) to source N, or to
+// every source without N:; tracked objects of the count class crossing it
+// from the left of x1,y1 -> x2,y2 to the right count as "in" (downwards for a
+// line drawn left to right), the other way as "out".
+// --zone adds a polygon zone (frame pixels) the same way; its count is the
+// tracked objects of the count class whose bottom-centre lies inside it,
+// every frame with one source, on each inference when batched.
+// --roi limits inference to a counting zone; give one per source (in source
+// order), or a single one for all sources.
+// --input-size sets the network input of source N, or of every source without
+// N: (e.g. 640x384 for a 16:9 camera, 416x416 for a square ROI). Batched
+// sources with different sizes go through one batcher and model instance per
+// size, since a batch is a single N x 3 x H x W tensor; --pool needs one size.
+// The model loads and warms up on a background thread while the sources
+// open; model_cache.yml remembers where it was found for the next start, and
+// with --backend onnxruntime model_cache.ort keeps the optimised graph.
+
+namespace {
+
+struct Options {
+    std::vector<std::string> sources;
+    DetectorConfig detector;
+    long maxFrames = 0; // 0 = until end of stream, per source
+    int reportEvery = 100;
+    bool motionGate = false;
+    int inferEvery = 1;
+    bool flow = false;
+    bool v4l2 = false;
+    bool mjpeg = false;
+    cv::Size captureSize;
+    InferenceBatcher::Config batch{ 1, 10.0 };
+    bool usePool = false;
+    InferencePool::Config pool;
+    std::vector<cv::Rect> rois;
+    std::vector<std::pair<int, cv::Size>> inputSizes; // source; default detector.inputSize
+    std::vector<std::pair<int, CountingLine>> lines; // source, -1 = all
+    std::vector<std::pair<int, CountingZone>> zones;
+
+    std::vector<CountingLine> LinesFor(size_t source, int countClass) const {
+        std::vector<CountingLine> result;
+        for (const auto& l : lines) {
+            if (l.first < 0 || (size_t)l.first == source) {
+                result.push_back(l.second);
+                result.back().classId = countClass;
+            }
+        }
+        return result;
+    }
+
+    std::vector<CountingZone> ZonesFor(size_t source, int countClass) const {
+        std::vector<CountingZone> result;
+        for (const auto& z : zones) {
+            if (z.first < 0 || (size_t)z.first == source) {
+                result.push_back(z.second);
+                result.back().classId = countClass;
+            }
+        }
+        return result;
+    }
+
+    cv::Size InputSizeFor(size_t source) const {
+        cv::Size size = detector.inputSize;
+        for (const auto& s : inputSizes) {
+            if ((size_t)s.first == source)
+                size = s.second;
+        }
+        return size;
+    }
+
+    cv::Rect RoiFor(size_t source) const {
+        if (rois.empty())
+            return cv::Rect();
+        return source < rois.size() ? rois[source] : rois.back();
+    }
+};
+
+// The detector's confThreshold is the tracker's high score; decode keeps the
+// boxes down to lowScore (DetectorConfig::trackThreshold) for its second pass.
+ByteTracker::Config TrackerConfigFor(const DetectorConfig& detector) {
+    ByteTracker::Config config;
+    config.highScore = detector.confThreshold;
+    config.newTrackScore = detector.confThreshold;
+    return config;
+}
+
+// "[N:]rest" -> source N (-1 without a prefix) and rest.
+int SplitSource(std::string& text) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos)
+        return -1;
+    const int source = std::max(0, std::atoi(text.substr(0, colon).c_str()));
+    text = text.substr(colon + 1);
+    return source;
+}
+
+void PrintUsage() {
+    std::cerr << "Usage: stream_counter [source...] [--model PATH] [--names PATH]"
+                 " [--input-size [N:]WxH]... [--frames N] [--report-every N] [--motion-gate]"
+                 " [--infer-every N] [--flow]"
+                 " [--batch N] [--max-wait-ms X] [--int8] [--roi x,y,w,h]..."
+                 " [--backend opencv|ort] [--pool M] [--threads K] [--pin]"
+                 " [--classes NAME,...] [--count-class NAME] [--agnostic-nms] [--line [N:]x1,y1,x2,y2]..."
+                 " [--zone [N:]x1,y1,x2,y2,x3,y3,...]... [--v4l2 WxH [--mjpeg]]\n";
+}
+
+bool ParseArgs(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << name << "\n";
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* value = nullptr;
+        if (arg == "--model") {
+            if (!(value = next("--model"))) return false;
+            opts.detector.modelPath = value;
+        } else if (arg == "--names") {
+            if (!(value = next("--names"))) return false;
+            opts.detector.classNamesPath = value;
+        } else if (arg == "--input-size") {
+            if (!(value = next("--input-size"))) return false;
+            std::string text = value;
+            const int source = SplitSource(text);
+            cv::Size size;
+            if (!ParseInputSize(text, size)) {
+                std::cerr << "Bad input size: " << value << "\n";
+                return false;
+            }
+            if (source < 0)
+                opts.detector.inputSize = size;
+            else
+                opts.inputSizes.emplace_back(source, size);
+        } else if (arg == "--frames") {
+            if (!(value = next("--frames"))) return false;
+            opts.maxFrames = std::atol(value);
+        } else if (arg == "--report-every") {
+            if (!(value = next("--report-every"))) return false;
+            opts.reportEvery = std::max(1, std::atoi(value));
+        } else if (arg == "--motion-gate") {
+            opts.motionGate = true;
+        } else if (arg == "--infer-every") {
+            if (!(value = next("--infer-every"))) return false;
+            opts.inferEvery = std::max(1, std::atoi(value));
+        } else if (arg == "--flow") {
+            opts.flow = true;
+        } else if (arg == "--v4l2") {
+            if (!(value = next("--v4l2"))) return false;
+            if (std::sscanf(value, "%dx%d", &opts.captureSize.width, &opts.captureSize.height) != 2) {
+                std::cerr << "Bad capture size: " << value << "\n";
+                return false;
+            }
+            opts.v4l2 = true;
+        } else if (arg == "--mjpeg") {
+            opts.mjpeg = true;
+        } else if (arg == "--roi") {
+            cv::Rect roi;
+            if (!(value = next("--roi"))) return false;
+            if (!ParseRoi(value, roi)) {
+                std::cerr << "Bad ROI: " << value << "\n";
+                return false;
+            }
+            opts.rois.push_back(roi);
+        } else if (arg == "--int8") {
+            opts.detector.precision = ModelPrecision::INT8;
+        } else if (arg == "--backend") {
+            if (!(value = next("--backend"))) return false;
+            if (!ParseBackendKind(value, opts.detector.backend)) {
+                std::cerr << "Unknown backend: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--classes") {
+            if (!(value = next("--classes"))) return false;
+            if (!ParseClassList(value, opts.detector.classes)) {
+                std::cerr << "Bad class list: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--count-class") {
+            if (!(value = next("--count-class"))) return false;
+            opts.detector.countClass = value;
+        } else if (arg == "--agnostic-nms") {
+            opts.detector.agnosticNms = true;
+        } else if (arg == "--line") {
+            if (!(value = next("--line"))) return false;
+            std::string text = value;
+            const int source = SplitSource(text);
+            CountingLine line;
+            if (!ParseCountingLine(text, line)) {
+                std::cerr << "Bad counting line: " << value << "\n";
+                return false;
+            }
+            opts.lines.emplace_back(source, line);
+        } else if (arg == "--zone") {
+            if (!(value = next("--zone"))) return false;
+            std::string text = value;
+            const int source = SplitSource(text);
+            CountingZone zone;
+            if (!ParseCountingZone(text, zone)) {
+                std::cerr << "Bad counting zone: " << value << "\n";
+                return false;
+            }
+            opts.zones.emplace_back(source, zone);
+        } else if (arg == "--pool") {
+            if (!(value = next("--pool"))) return false;
+            opts.usePool = true;
+            opts.pool.instances = std::max(0, std::atoi(value));
+        } else if (arg == "--threads") {
+            if (!(value = next("--threads"))) return false;
+            opts.pool.threadsPerInstance = std::max(1, std::atoi(value));
+        } else if (arg == "--pin") {
+            opts.pool.pin = true;
+        } else if (arg == "--batch") {
+            if (!(value = next("--batch"))) return false;
+            opts.batch.maxBatch = std::max(1, std::atoi(value));
+        } else if (arg == "--max-wait-ms") {
+            if (!(value = next("--max-wait-ms"))) return false;
+            opts.batch.maxWaitMs = std::max(0.0, std::atof(value));
+        } else if (arg == "-h" || arg == "--help") {
+            return false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            opts.sources.push_back(arg);
+        }
+    }
+    if (opts.sources.empty())
+        opts.sources.push_back("0");
+#ifndef HAVE_V4L2
+    if (opts.v4l2) {
+        std::cerr << "--v4l2 needs a Linux build\n";
+        return false;
+    }
+#endif
+    if (opts.mjpeg) {
+#ifndef HAVE_LIBJPEG
+        std::cerr << "--mjpeg needs a build with libjpeg-turbo\n";
+        return false;
+#endif
+        if (!opts.v4l2 || opts.flow) {
+            std::cerr << "--mjpeg needs --v4l2 and does not work with --flow\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsDeviceIndex(const std::string& s) {
+    if (s.empty())
+        return false;
+    for (char c : s) {
+        if (!std::isdigit(static_cast<unsigned char>(c)))
+            return false;
+    }
+    return true;
+}
+
+bool OpenSource(const std::string& source, cv::VideoCapture& cap) {
+    if (IsDeviceIndex(source))
+        cap.open(std::atoi(source.c_str()), cv::CAP_V4L2);
+    else
+        cap.open(source);
+    if (!cap.isOpened()) {
+        std::cerr << "Cannot open source " << source << "\n";
+        return false;
+    }
+    std::cout << "Source: " << source << " (" << cap.get(cv::CAP_PROP_FRAME_WIDTH) << "x"
+              << cap.get(cv::CAP_PROP_FRAME_HEIGHT) << ")\n";
+    return true;
+}
+
+#ifdef HAVE_V4L2
+bool OpenV4L2(const Options& opts, V4L2Capture& capture) {
+    const std::string& source = opts.sources[0];
+    if (!IsDeviceIndex(source)) {
+        std::cerr << "--v4l2 needs a device index, not " << source << "\n";
+        return false;
+    }
+    V4L2Capture::Config config;
+    config.width = opts.captureSize.width;
+    config.height = opts.captureSize.height;
+    config.format = opts.mjpeg ? PixelFormat::MJPEG : PixelFormat::NV12;
+    if (!capture.Open("/dev/video" + source, config))
+        return false;
+    std::cout << "Source: /dev/video" << source << " (" << capture.Width() << "x" << capture.Height() << " "
+              << PixelFormatName(capture.Format()) << ", " << capture.Buffers() << " mmap buffers)\n";
+    return true;
+}
+#endif
+
+void PrintStage(const char* name, const LatencyStats& stats) {
+    std::cout << "  " << std::left << std::setw(11) << name << std::right
+              << " mean " << std::setw(8) << stats.Mean()
+              << "  p50 " << std::setw(8) << stats.Percentile(50)
+              << "  p99 " << std::setw(8) << stats.Percentile(99) << " ms\n";
+}
+
+// Joins the background loader and reports how long the model took.
+YoloDetector* WaitForModel(ModelManager& models) {
+    if (!models.Wait()) {
+        std::cerr << "Cannot load YOLO model\n";
+        return nullptr;
+    }
+    const ModelCache& stats = models.Stats();
+    std::cout << "Model ready: load " << stats.loadMs << " ms"
+              << (models.OptimizedHit() ? " (optimised model from cache)"
+                  : models.CacheHit() ? " (model path from cache)" : "")
+              << ", warm-up " << stats.warmupMs
+              << " ms, steady forward " << stats.forwardMs << " ms\n";
+    return &models.Detector();
+}
+
+int RunSingle(const Options& opts, ModelManager& models) {
+    cv::VideoCapture cap;
+#ifdef HAVE_V4L2
+    V4L2Capture v4l2;
+    if (opts.v4l2 ? !OpenV4L2(opts, v4l2) : !OpenSource(opts.sources[0], cap))
+        return 1;
+#else
+    if (!OpenSource(opts.sources[0], cap))
+        return 1;
+#endif
+    YoloDetector* model = WaitForModel(models);
+    if (!model)
+        return 1;
+    YoloDetector& detector = *model;
+
+    LatencyStats captureStats, preprocessStats, forwardStats, decodeStats, nmsStats, totalStats;
+    MotionGate gate;
+    ByteTracker tracker(TrackerConfigFor(detector.Config()));
+    FlowPropagator flow;
+    const int countClass = detector.Config().countClassId;
+    LineCounter lineCounter(opts.LinesFor(0, countClass));
+    ZoneCounter zoneCounter(opts.ZonesFor(0, countClass));
+    cv::Mat frame, grey;
+    CapturedFrame raw;
+#ifdef HAVE_LIBJPEG
+    MjpegDecoder mjpeg;
+#endif
+    long frames = 0;
+    long inferred = 0;
+    int lastCount = 0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    const auto runStart = BenchClock::now();
+    auto windowStart = runStart;
+
+    while (opts.maxFrames == 0 || frames < opts.maxFrames) {
+        auto frameStart = BenchClock::now();
+        if (opts.v4l2) {
+#ifdef HAVE_V4L2
+            if (!v4l2.Acquire(raw))
+                break;
+#endif
+            if (!opts.mjpeg)
+                grey = FrameLuma(raw);
+        } else if (!cap.read(frame) || frame.empty()) {
+            break;
+        }
+        captureStats.Add(MsSince(frameStart));
+        const cv::Size frameSize = opts.v4l2 ? cv::Size(raw.width, raw.height) : frame.size();
+
+        bool infer = frames % opts.inferEvery == 0;
+        if ((opts.motionGate || opts.flow) && !opts.v4l2)
+            cv::cvtColor(frame, grey, cv::COLOR_BGR2GRAY);
+        double jpegMs = 0.0;
+#ifdef HAVE_LIBJPEG
+        if (opts.mjpeg && infer) {
+            const auto decodeStart = BenchClock::now();
+            infer = mjpeg.DecodeForInput(raw.data, raw.bytes, detector.Config().inputSize, detector.Config().roi);
+            if (infer && opts.motionGate)
+                cv::cvtColor(mjpeg.Scaled(), grey, cv::COLOR_BGR2GRAY);
+            jpegMs = MsSince(decodeStart);
+        }
+#endif
+        if (infer && opts.motionGate)
+            infer = gate.Check(grey.data, (int)grey.step, grey.cols, grey.rows);
+
+        StageTimings t;
+        if (infer) {
+            if (!opts.v4l2)
+                lastCount = detector.CountObjects(frame, &t);
+#ifdef HAVE_LIBJPEG
+            else if (opts.mjpeg)
+                lastCount = detector.CountObjectsScaled(mjpeg.Scaled(), mjpeg.Denom(), &t);
+#endif
+            else
+                lastCount = detector.CountObjectsNV12(raw.data, raw.stride, raw.UvPlane(), raw.stride, raw.width,
+                                                      raw.height, &t);
+            t.preprocessMs += jpegMs; // scaled MJPEG decode
+            tracker.Update(detector.Detections(), frames);
+            if (opts.flow)
+                flow.Seed(grey, tracker);
+            lineCounter.Update(tracker);
+            preprocessStats.Add(t.preprocessMs);
+            forwardStats.Add(t.forwardMs);
+            decodeStats.Add(t.decodeMs);
+            nmsStats.Add(t.nmsMs);
+            ++inferred;
+        } else {
+            // Advance the tracks so line crossings keep up on skipped frames
+            if (opts.flow)
+                flow.Propagate(grey, tracker);
+            else
+                tracker.Predict();
+            lineCounter.Update(tracker);
+        }
+        // Tracked boxes, predicted on skipped frames, so zones keep up too
+        zoneCounter.Prepare(frameSize);
+        zoneCounter.Count(tracker);
+#ifdef HAVE_V4L2
+        if (opts.v4l2)
+            v4l2.Release(raw);
+#endif
+        totalStats.Add(MsSince(frameStart));
+        ++frames;
+
+        if (frames % opts.reportEvery == 0) {
+            double windowSec = MsSince(windowStart) / 1000.0;
+            std::cout << "[" << frames << "] " << opts.reportEvery / windowSec << " fps"
+                      << "  count " << lastCount
+                      << "  present " << tracker.Occupancy(countClass)
+                      << "  unique " << tracker.UniqueCount(countClass);
+            if (lineCounter.Lines() > 0)
+                std::cout << "  in " << lineCounter.TotalIn() << "  out " << lineCounter.TotalOut();
+            if (zoneCounter.Zones() > 0) {
+                std::cout << "  zones";
+                for (int z = 0; z < zoneCounter.Zones(); ++z)
+                    std::cout << " " << zoneCounter.Occupancy(z);
+            }
+            std::cout << "  fwd " << t.forwardMs << " ms\n";
+            windowStart = BenchClock::now();
+        }
+    }
+
+    double elapsedSec = MsSince(runStart) / 1000.0;
+    std::cout << "\nFrames: " << frames << "  elapsed " << elapsedSec << " s  sustained "
+              << (elapsedSec > 0 ? frames / elapsedSec : 0.0) << " fps  last count " << lastCount
+              << "  unique " << tracker.UniqueCount(countClass) << "\n";
+    for (int i = 0; i < lineCounter.Lines(); ++i)
+        std::cout << "Line " << i << ": in " << lineCounter.In(i) << "  out " << lineCounter.Out(i) << "\n";
+    std::cout << "Inferred " << inferred << " / " << frames << " frames";
+    if (opts.motionGate)
+        std::cout << " (motion gate skipped " << gate.SkippedFrames() << ")";
+    std::cout << "\n";
+    PrintStage("capture", captureStats);
+    PrintStage("preprocess", preprocessStats);
+    PrintStage("forward", forwardStats);
+    PrintStage("decode", decodeStats);
+    PrintStage("nms", nmsStats);
+    PrintStage("total", totalStats);
+    return 0;
+}
+
+bool OpenSources(const Options& opts, std::vector<cv::VideoCapture>& caps) {
+    caps.resize(opts.sources.size());
+    for (size_t i = 0; i < opts.sources.size(); ++i) {
+        if (!OpenSource(opts.sources[i], caps[i]))
+            return false;
+    }
+    return true;
+}
+
+// Per-source counters shared by the capture threads and the result callback.
+// Results of one source arrive in order on one thread at a time, so each
+// source's tracker needs no lock; counts are published as atomics.
+struct SourceCounters {
+    SourceCounters(const Options& opts, size_t n, const DetectorConfig& detector)
+        : countClass(detector.countClassId), captured(new std::atomic<long>[n]), inferred(new std::atomic<long>[n]),
+          counts(new std::atomic<int>[n]), unique(new std::atomic<int>[n]),
+          trackers(n, ByteTracker(TrackerConfigFor(detector))) {
+        for (size_t i = 0; i < n; ++i) {
+            captured[i] = 0;
+            inferred[i] = 0;
+            counts[i] = 0;
+            unique[i] = 0;
+            lineCounters.emplace_back(opts.LinesFor(i, detector.countClassId));
+            zoneCounters.emplace_back(opts.ZonesFor(i, detector.countClassId));
+        }
+    }
+
+    // Rasterises each source's zones at its capture resolution.
+    void PrepareZones(std::vector<cv::VideoCapture>& caps) {
+        for (size_t i = 0; i < caps.size(); ++i)
+            zoneCounters[i].Prepare(cv::Size((int)caps[i].get(cv::CAP_PROP_FRAME_WIDTH),
+                                             (int)caps[i].get(cv::CAP_PROP_FRAME_HEIGHT)));
+    }
+
+    void OnResult(const BatchResult& r) {
+        ByteTracker& tracker = trackers[r.streamId];
+        if (r.detections) {
+            tracker.Update(*r.detections, r.timestamp); // capture frame index
+            zoneCounters[r.streamId].Count(tracker);
+        }
+        lineCounters[r.streamId].Update(tracker);
+        counts[r.streamId].store(tracker.Occupancy(countClass), std::memory_order_relaxed);
+        unique[r.streamId].store(tracker.UniqueCount(countClass), std::memory_order_relaxed);
+        inferred[r.streamId].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const int countClass;
+    std::unique_ptr<std::atomic<long>[]> captured;
+    std::unique_ptr<std::atomic<long>[]> inferred;
+    std::unique_ptr<std::atomic<int>[]> counts; // tracked objects present
+    std::unique_ptr<std::atomic<int>[]> unique;
+    std::vector<ByteTracker> trackers;
+    std::vector<LineCounter> lineCounters; // in / out are atomics
+    std::vector<ZoneCounter> zoneCounters; // occupancy is atomic
+};
+
+// One capture thread per source feeding engine (InferenceBatcher or
+// InferencePool) until the sources end; prints a status line every second.
+// Returns the elapsed time in seconds.
+template <class Engine>
+double RunCaptureThreads(const Options& opts, std::vector<cv::VideoCapture>& caps, Engine& engine,
+                         SourceCounters& counters, const std::function<void(std::ostream&)>& status) {
+    const size_t numSources = caps.size();
+    std::atomic<size_t> running{ numSources };
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numSources; ++i) {
+        threads.emplace_back([&, i] {
+            cv::Mat frame;
+            long n = 0;
+            while ((opts.maxFrames == 0 || n < opts.maxFrames) && caps[i].read(frame) && !frame.empty()) {
+                engine.SubmitBGR((int)i, frame, n++);
+                counters.captured[i].fetch_add(1, std::memory_order_relaxed);
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    const auto runStart = BenchClock::now();
+    uint64_t lastFrames = 0;
+    while (running.load() > 0) {
+        auto windowStart = BenchClock::now();
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const uint64_t frames = engine.Frames();
+        std::cout << "[" << frames << "] " << (frames - lastFrames) * 1000.0 / MsSince(windowStart)
+                  << " inferred fps  ";
+        status(std::cout);
+        std::cout << "  present/unique";
+        for (size_t i = 0; i < numSources; ++i)
+            std::cout << " " << counters.counts[i].load(std::memory_order_relaxed) << "/"
+                      << counters.unique[i].load(std::memory_order_relaxed);
+        if (!opts.lines.empty()) {
+            std::cout << "  in/out";
+            for (size_t i = 0; i < numSources; ++i)
+                std::cout << " " << counters.lineCounters[i].TotalIn() << "/" << counters.lineCounters[i].TotalOut();
+        }
+        if (!opts.zones.empty()) {
+            std::cout << "  zones";
+            for (size_t i = 0; i < numSources; ++i) {
+                const ZoneCounter& zones = counters.zoneCounters[i];
+                for (int z = 0; z < zones.Zones(); ++z)
+                    std::cout << (z == 0 ? " " : "/") << zones.Occupancy(z);
+            }
+        }
+        std::cout << "\n";
+        lastFrames = frames;
+    }
+    for (std::thread& t : threads)
+        t.join();
+    return MsSince(runStart) / 1000.0;
+}
+
+// Batched sources grouped by network input size: one InferenceBatcher, with
+// its own model instance, per size. Looks like a single batcher to
+// RunCaptureThreads.
+struct SizedBatchers {
+    std::vector<cv::Size> sizes;
+    std::vector<std::vector<int>> sources;              // per batcher, in stream order
+    std::vector<int> batcherOf, streamOf;               // per source
+    std::vector<std::unique_ptr<YoloDetector>> models;  // sizes other than the shared model's
+    std::vector<std::unique_ptr<InferenceBatcher>> batchers;
+
+    void SubmitBGR(int source, const cv::Mat& bgr, int64_t timestamp) {
+        batchers[batcherOf[source]]->SubmitBGR(streamOf[source], bgr, timestamp);
+    }
+
+    uint64_t Frames() const { return Sum(&InferenceBatcher::Frames); }
+    uint64_t Batches() const { return Sum(&InferenceBatcher::Batches); }
+    double MeanBatchSize() const {
+        const uint64_t b = Batches();
+        return b ? (double)Frames() / b : 0.0;
+    }
+
+    uint64_t Sum(uint64_t (InferenceBatcher::*stat)() const) const {
+        uint64_t total = 0;
+        for (const auto& batcher : batchers)
+            total += (*batcher.*stat)();
+        return total;
+    }
+};
+
+void PrintSources(const Options& opts, const SourceCounters& counters) {
+    for (size_t i = 0; i < opts.sources.size(); ++i) {
+        std::cout << "  " << opts.sources[i] << ": inferred " << counters.inferred[i].load() << " / "
+                  << counters.captured[i].load() << " frames  present " << counters.counts[i].load()
+                  << "  unique " << counters.unique[i].load();
+        const LineCounter& lines = counters.lineCounters[i];
+        for (int l = 0; l < lines.Lines(); ++l)
+            std::cout << "  line " << l << " in " << lines.In(l) << " out " << lines.Out(l);
+        const ZoneCounter& zones = counters.zoneCounters[i];
+        for (int z = 0; z < zones.Zones(); ++z)
+            std::cout << "  zone " << z << " " << zones.Occupancy(z);
+        std::cout << "\n";
+    }
+}
+
+int RunBatched(const Options& opts, ModelManager& models) {
+    std::vector<cv::VideoCapture> caps;
+    if (!OpenSources(opts, caps))
+        return 1;
+    YoloDetector* model = WaitForModel(models);
+    if (!model)
+        return 1;
+    YoloDetector& detector = *model;
+
+    const size_t numSources = caps.size();
+    SourceCounters counters(opts, numSources, detector.Config());
+    counters.PrepareZones(caps);
+
+    // Source 0's size is the shared model's (see main); other sizes load their own
+    SizedBatchers group;
+    for (size_t i = 0; i < numSources; ++i) {
+        const cv::Size size = opts.InputSizeFor(i);
+        const size_t b = std::find(group.sizes.begin(), group.sizes.end(), size) - group.sizes.begin();
+        if (b == group.sizes.size()) {
+            group.sizes.push_back(size);
+            group.sources.emplace_back();
+        }
+        group.batcherOf.push_back((int)b);
+        group.streamOf.push_back((int)group.sources[b].size());
+        group.sources[b].push_back((int)i);
+    }
+
+    LatencyStats forwardStats;
+    for (size_t b = 0; b < group.sizes.size(); ++b) {
+        YoloDetector* model = &detector;
+        if (group.sizes[b] != detector.Config().inputSize) {
+            DetectorConfig config = detector.Config();
+            config.inputSize = group.sizes[b];
+            config.optimizedModelPath.clear();
+            group.models.push_back(std::make_unique<YoloDetector>());
+            model = group.models.back().get();
+            if (!model->Load(config)) {
+                std::cerr << "Cannot load YOLO model at " << config.inputSize << "\n";
+                return 1;
+            }
+            model->Backend().Warmup(1);
+        }
+        if (group.sizes.size() > 1)
+            std::cout << "Input " << group.sizes[b] << ": " << group.sources[b].size() << " source(s)\n";
+
+        const std::vector<int>& sources = group.sources[b];
+        group.batchers.push_back(std::make_unique<InferenceBatcher>(
+            model->Backend(), model->Config(), opts.batch, [&, b](const BatchResult& r) {
+                BatchResult result = r;
+                result.streamId = group.sources[b][r.streamId];
+                counters.OnResult(result);
+                if (result.streamId == 0)
+                    forwardStats.Add(r.forwardMs);
+            }));
+        for (int source : sources)
+            group.batchers.back()->AddStream(opts.RoiFor(source));
+    }
+    for (auto& batcher : group.batchers)
+        batcher->Start();
+
+    const double elapsedSec = RunCaptureThreads(opts, caps, group, counters, [&](std::ostream& os) {
+        os << "batch " << group.MeanBatchSize();
+    });
+    for (auto& batcher : group.batchers)
+        batcher->Stop();
+
+    std::cout << "\nSources: " << numSources << "  elapsed " << elapsedSec << " s  aggregate "
+              << (elapsedSec > 0 ? group.Frames() / elapsedSec : 0.0) << " inferred fps\n"
+              << "Batches: " << group.Batches() << "  mean size " << group.MeanBatchSize() << "  max";
+    for (const auto& batcher : group.batchers)
+        std::cout << " " << batcher->MaxBatch();
+    std::cout << "\n";
+    PrintSources(opts, counters);
+    PrintStage("forward", forwardStats);
+    return 0;
+}
+
+int RunPooled(const Options& opts, ModelManager& models) {
+    std::vector<cv::VideoCapture> caps;
+    if (!OpenSources(opts, caps))
+        return 1;
+    YoloDetector* model = WaitForModel(models);
+    if (!model)
+        return 1;
+
+    const size_t numSources = caps.size();
+    for (size_t i = 1; i < numSources; ++i) {
+        if (opts.InputSizeFor(i) != opts.InputSizeFor(0)) {
+            std::cerr << "--pool needs one --input-size: every instance serves every source\n";
+            return 1;
+        }
+    }
+    SourceCounters counters(opts, numSources, model->Config());
+    counters.PrepareZones(caps);
+    InferencePool pool(opts.pool, [&](const BatchResult& r) { counters.OnResult(r); });
+    for (size_t i = 0; i < numSources; ++i)
+        pool.AddStream(opts.RoiFor(i));
+    const auto loadStart = BenchClock::now();
+    if (!pool.Start(model->Config()))
+        return 1;
+    std::cout << "Pool: " << pool.Instances() << " instances x " << pool.ThreadsPerInstance()
+              << " threads" << (opts.pool.pin ? ", pinned" : "") << ", loaded in "
+              << MsSince(loadStart) << " ms\n";
+
+    const double elapsedSec = RunCaptureThreads(opts, caps, pool, counters, [&](std::ostream& os) {
+        os << "replaced " << pool.Replaced();
+    });
+    pool.Stop();
+
+    std::cout << "\nSources: " << numSources << "  elapsed " << elapsedSec << " s  aggregate "
+              << (elapsedSec > 0 ? pool.Frames() / elapsedSec : 0.0) << " inferred fps  replaced "
+              << pool.Replaced() << "\n";
+    PrintSources(opts, counters);
+    for (int i = 0; i < pool.Instances(); ++i) {
+        const InferencePool::InstanceStats stats = pool.Stats(i);
+        std::cout << "  instance " << std::setw(2) << i << ": " << std::setw(6) << stats.frames
+                  << " frames  mean " << std::setw(7) << (stats.frames ? stats.busyMs / stats.frames : 0.0)
+                  << " ms  busy " << std::setw(5) << (elapsedSec > 0 ? stats.busyMs / (elapsedSec * 10.0) : 0.0)
+                  << " %";
+        if (!stats.cores.empty())
+            std::cout << "  cores " << stats.cores;
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        PrintUsage();
+        return 1;
+    }
+
+    ModelManager models;
+    ModelManager::Config modelConfig;
+    modelConfig.detector = opts.detector;
+    modelConfig.detector.roi = opts.RoiFor(0);
+    modelConfig.detector.inputSize = opts.InputSizeFor(0);
+    modelConfig.detector.trackThreshold = ByteTracker::Config().lowScore; // every source is tracked
+    models.Start(modelConfig);
+
+    std::cout << std::fixed << std::setprecision(2);
+    if (opts.usePool)
+        return RunPooled(opts, models);
+    if (opts.sources.size() > 1 || opts.batch.maxBatch > 1)
+        return RunBatched(opts, models);
+    return RunSingle(opts, models);
+}
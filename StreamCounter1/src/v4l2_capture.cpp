@@ -0,0 +1,299 @@
+#include "v4l2_capture.hpp"
+
+#include <linux/videodev2.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+namespace {
+
+int Xioctl(int fd, unsigned long request, void* arg) {
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r == -1 && errno == EINTR);
+    return r;
+}
+
+uint32_t FourCC(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::NV12: return V4L2_PIX_FMT_NV12;
+    case PixelFormat::YUYV: return V4L2_PIX_FMT_YUYV;
+    default: return V4L2_PIX_FMT_MJPEG;
+    }
+}
+
+size_t FrameBytes(PixelFormat format, int width, int height) {
+    return format == PixelFormat::YUYV ? (size_t)width * height * 2 : (size_t)width * height * 3 / 2;
+}
+
+double MonotonicMs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+} // namespace
+
+const char* PixelFormatName(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::NV12: return "nv12";
+    case PixelFormat::YUYV: return "yuyv";
+    default: return "mjpeg";
+    }
+}
+
+bool ParsePixelFormat(const std::string& text, PixelFormat& format) {
+    std::string lower(text);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    for (PixelFormat f : { PixelFormat::NV12, PixelFormat::YUYV, PixelFormat::MJPEG }) {
+        if (lower == PixelFormatName(f)) {
+            format = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool V4L2Capture::Open(const std::string& device, const Config& config) {
+    Close();
+    device_ = device;
+    fd_ = open(device.c_str(), O_RDWR | O_NONBLOCK);
+    if (fd_ < 0) {
+        std::cerr << "Cannot open " << device << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    auto fail = [&](const char* what) {
+        std::cerr << device << ": " << what << " failed: " << std::strerror(errno) << "\n";
+        Close();
+        return false;
+    };
+
+    v4l2_capability cap{};
+    if (Xioctl(fd_, VIDIOC_QUERYCAP, &cap) < 0)
+        return fail("VIDIOC_QUERYCAP");
+    const uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING)) {
+        std::cerr << device << ": not a streaming capture device\n";
+        Close();
+        return false;
+    }
+
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = config.width;
+    fmt.fmt.pix.height = config.height;
+    fmt.fmt.pix.pixelformat = FourCC(config.format);
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (Xioctl(fd_, VIDIOC_S_FMT, &fmt) < 0)
+        return fail("VIDIOC_S_FMT");
+    if (fmt.fmt.pix.pixelformat != FourCC(config.format)) {
+        std::cerr << device << ": no " << PixelFormatName(config.format) << " support\n";
+        Close();
+        return false;
+    }
+    width_ = (int)fmt.fmt.pix.width;
+    height_ = (int)fmt.fmt.pix.height;
+    format_ = config.format;
+    stride_ = fmt.fmt.pix.bytesperline ? (int)fmt.fmt.pix.bytesperline
+                                       : (format_ == PixelFormat::YUYV ? width_ * 2 : width_);
+
+    v4l2_requestbuffers req{};
+    req.count = std::max(2, config.buffers);
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (Xioctl(fd_, VIDIOC_REQBUFS, &req) < 0)
+        return fail("VIDIOC_REQBUFS");
+    if (req.count < 2) {
+        std::cerr << device << ": driver granted " << req.count << " buffers\n";
+        Close();
+        return false;
+    }
+
+    buffers_.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (Xioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0)
+            return fail("VIDIOC_QUERYBUF");
+        void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+        if (start == MAP_FAILED)
+            return fail("mmap");
+        buffers_[i].start = start;
+        buffers_[i].length = buf.length;
+        if (Xioctl(fd_, VIDIOC_QBUF, &buf) < 0)
+            return fail("VIDIOC_QBUF");
+    }
+
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (Xioctl(fd_, VIDIOC_STREAMON, &type) < 0)
+        return fail("VIDIOC_STREAMON");
+    return true;
+}
+
+void V4L2Capture::Close() {
+    if (fd_ < 0)
+        return;
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    Xioctl(fd_, VIDIOC_STREAMOFF, &type);
+    for (Buffer& b : buffers_) {
+        if (b.start)
+            munmap(b.start, b.length);
+    }
+    buffers_.clear();
+    v4l2_requestbuffers req{};
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    Xioctl(fd_, VIDIOC_REQBUFS, &req);
+    close(fd_);
+    fd_ = -1;
+    held_ = 0;
+    haveSequence_ = false;
+    dropped_ = 0;
+}
+
+bool V4L2Capture::Acquire(CapturedFrame& frame, int timeoutMs) {
+    if (fd_ < 0 || held_ >= (int)buffers_.size())
+        return false;
+
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    for (;;) {
+        if (Xioctl(fd_, VIDIOC_DQBUF, &buf) == 0)
+            break;
+        if (errno != EAGAIN) {
+            std::cerr << device_ << ": VIDIOC_DQBUF failed: " << std::strerror(errno) << "\n";
+            return false;
+        }
+        pollfd pfd{ fd_, POLLIN, 0 };
+        int r;
+        do {
+            r = poll(&pfd, 1, timeoutMs);
+        } while (r < 0 && errno == EINTR);
+        if (r <= 0)
+            return false; // timeout or error
+    }
+
+    if (haveSequence_ && buf.sequence > lastSequence_ + 1)
+        dropped_ += buf.sequence - lastSequence_ - 1;
+    haveSequence_ = true;
+    lastSequence_ = buf.sequence;
+
+    Buffer& b = buffers_[buf.index];
+    b.held = true;
+    ++held_;
+    frame.data = static_cast<const uint8_t*>(b.start);
+    frame.bytes = buf.bytesused ? buf.bytesused : b.length;
+    frame.index = (int)buf.index;
+    frame.sequence = buf.sequence;
+    frame.ageMs = 0.0;
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC)
+        frame.ageMs = MonotonicMs() - (buf.timestamp.tv_sec * 1000.0 + buf.timestamp.tv_usec / 1000.0);
+    frame.width = width_;
+    frame.height = height_;
+    frame.stride = stride_;
+    frame.format = format_;
+    return true;
+}
+
+void V4L2Capture::Release(const CapturedFrame& frame) {
+    if (fd_ < 0 || frame.index < 0 || frame.index >= (int)buffers_.size() || !buffers_[frame.index].held)
+        return;
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = (uint32_t)frame.index;
+    if (Xioctl(fd_, VIDIOC_QBUF, &buf) < 0) {
+        std::cerr << device_ << ": VIDIOC_QBUF failed: " << std::strerror(errno) << "\n";
+        return;
+    }
+    buffers_[frame.index].held = false;
+    --held_;
+}
+
+bool RawFileCapture::Open(const std::string& path, const V4L2Capture::Config& config, bool loop) {
+    Close();
+    if (config.format == PixelFormat::MJPEG) {
+        std::cerr << "Raw capture file needs nv12 or yuyv frames\n";
+        return false;
+    }
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat st;
+    frameBytes_ = FrameBytes(config.format, config.width, config.height);
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < frameBytes_) {
+        std::cerr << path << ": smaller than one " << config.width << "x" << config.height << " "
+                  << PixelFormatName(config.format) << " frame\n";
+        close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << path << ": mmap failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    base_ = static_cast<const uint8_t*>(base);
+    mapped_ = (size_t)st.st_size;
+    frames_ = mapped_ / frameBytes_;
+    config_ = config;
+    config_.buffers = std::max(2, config.buffers);
+    loop_ = loop;
+    next_ = 0;
+    heldSlots_.assign(config_.buffers, false);
+    held_ = 0;
+    return true;
+}
+
+void RawFileCapture::Close() {
+    if (base_)
+        munmap(const_cast<uint8_t*>(base_), mapped_);
+    base_ = nullptr;
+    mapped_ = 0;
+    frames_ = 0;
+    heldSlots_.clear();
+    held_ = 0;
+}
+
+bool RawFileCapture::Acquire(CapturedFrame& frame) {
+    if (!base_ || held_ >= config_.buffers || (!loop_ && next_ >= frames_))
+        return false;
+    const int slot = (int)(std::find(heldSlots_.begin(), heldSlots_.end(), false) - heldSlots_.begin());
+    heldSlots_[slot] = true;
+    ++held_;
+
+    frame.data = base_ + (next_ % frames_) * frameBytes_;
+    frame.bytes = frameBytes_;
+    frame.index = slot;
+    frame.sequence = next_++;
+    frame.ageMs = 0.0;
+    frame.width = config_.width;
+    frame.height = config_.height;
+    frame.stride = config_.format == PixelFormat::YUYV ? config_.width * 2 : config_.width;
+    frame.format = config_.format;
+    return true;
+}
+
+void RawFileCapture::Release(const CapturedFrame& frame) {
+    if (frame.index < 0 || frame.index >= (int)heldSlots_.size() || !heldSlots_[frame.index])
+        return;
+    heldSlots_[frame.index] = false;
+    --held_;
+}
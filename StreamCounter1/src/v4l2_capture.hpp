@@ -0,0 +1,145 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class PixelFormat { NV12, YUYV, MJPEG };
+
+const char* PixelFormatName(PixelFormat format);
+// "nv12", "yuyv" or "mjpeg" (case-insensitive).
+bool ParsePixelFormat(const std::string& text, PixelFormat& format);
+
+// One filled capture buffer, read in place: data points into the driver's
+// (or the mapped file's) memory and stays valid until the frame is handed
+// back with Release().
+struct CapturedFrame {
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;     // payload (bytesused); varies per frame for MJPEG
+    int index = -1;       // buffer slot, for Release()
+    uint32_t sequence = 0;
+    double ageMs = 0.0;   // driver timestamp -> dequeue; 0 if the driver has no monotonic timestamps
+    int width = 0, height = 0;
+    int stride = 0;       // bytes per line of the Y (NV12) or packed (YUYV) plane
+    PixelFormat format = PixelFormat::NV12;
+
+    const uint8_t* UvPlane() const { return data + (size_t)stride * height; } // NV12
+};
+
+// Zero-copy Mat headers over a frame: NV12 as (3/2 h) x w CV_8UC1 (cvtColor
+// COLOR_YUV2BGR_NV12 input), YUYV as h x w CV_8UC2, MJPEG as 1 x bytes.
+inline cv::Mat FrameView(const CapturedFrame& frame) {
+    uint8_t* data = const_cast<uint8_t*>(frame.data);
+    switch (frame.format) {
+    case PixelFormat::NV12: return cv::Mat(frame.height * 3 / 2, frame.width, CV_8UC1, data, frame.stride);
+    case PixelFormat::YUYV: return cv::Mat(frame.height, frame.width, CV_8UC2, data, frame.stride);
+    default: return cv::Mat(1, (int)frame.bytes, CV_8UC1, data);
+    }
+}
+
+// Luma of an NV12 frame, e.g. for MotionGate or FlowPropagator.
+inline cv::Mat FrameLuma(const CapturedFrame& frame) {
+    return cv::Mat(frame.height, frame.width, CV_8UC1, const_cast<uint8_t*>(frame.data), frame.stride);
+}
+
+// Native V4L2 streaming capture with mmap'd driver buffers.
+//
+// Open() negotiates the format, requests Config::buffers MMAP buffers, maps
+// and queues them all and starts streaming. Acquire() polls for the next
+// filled buffer, dequeues it (VIDIOC_DQBUF) and hands it out as a view, no
+// copy and no colour conversion; Release() queues it back (VIDIOC_QBUF).
+// Frames may be held across inference as long as the driver keeps at least
+// one buffer to fill; a consumer that holds them all makes Acquire() fail.
+// Not thread-safe, but Release() may follow Acquire() on another thread if
+// the caller orders the two.
+class V4L2Capture {
+public:
+    struct Config {
+        int width = 1920;
+        int height = 1080;
+        PixelFormat format = PixelFormat::NV12;
+        int buffers = 4;
+    };
+
+    V4L2Capture() = default;
+    V4L2Capture(const V4L2Capture&) = delete;
+    V4L2Capture& operator=(const V4L2Capture&) = delete;
+    ~V4L2Capture() { Close(); }
+
+    // device: "/dev/videoN". The driver may adjust the size; see Width().
+    bool Open(const std::string& device, const Config& config);
+    void Close();
+    bool IsOpened() const { return fd_ >= 0; }
+
+    // Waits up to timeoutMs for a frame; false on timeout, error, or with
+    // every buffer held.
+    bool Acquire(CapturedFrame& frame, int timeoutMs = 1000);
+    void Release(const CapturedFrame& frame);
+
+    int Width() const { return width_; }
+    int Height() const { return height_; }
+    int Stride() const { return stride_; }
+    PixelFormat Format() const { return format_; }
+    int Buffers() const { return (int)buffers_.size(); }
+    int Held() const { return held_; }
+    // Frames the driver dropped, from gaps in the buffer sequence numbers.
+    uint32_t Dropped() const { return dropped_; }
+
+private:
+    struct Buffer {
+        void* start = nullptr;
+        size_t length = 0;
+        bool held = false;
+    };
+
+    int fd_ = -1;
+    std::string device_;
+    std::vector<Buffer> buffers_;
+    int width_ = 0, height_ = 0, stride_ = 0;
+    PixelFormat format_ = PixelFormat::NV12;
+    int held_ = 0;
+    bool haveSequence_ = false;
+    uint32_t lastSequence_ = 0;
+    uint32_t dropped_ = 0;
+};
+
+// File-backed stand-in for V4L2Capture, for benchmarks and CI boxes without
+// a camera or the vivid driver: a raw file of back-to-back NV12 or YUYV
+// frames is mapped once and handed out with the same Acquire() / Release()
+// contract over Config::buffers slots, so consumers holding frames behave as
+// they would against a driver. Frames are served as fast as they are
+// released (no pacing); with loop, the file repeats.
+class RawFileCapture {
+public:
+    RawFileCapture() = default;
+    RawFileCapture(const RawFileCapture&) = delete;
+    RawFileCapture& operator=(const RawFileCapture&) = delete;
+    ~RawFileCapture() { Close(); }
+
+    // config.format must be NV12 or YUYV; the stride is the width.
+    bool Open(const std::string& path, const V4L2Capture::Config& config, bool loop = true);
+    void Close();
+    bool IsOpened() const { return base_ != nullptr; }
+
+    // Never waits; false at the end of the file or with every slot held.
+    bool Acquire(CapturedFrame& frame);
+    void Release(const CapturedFrame& frame);
+
+    int Width() const { return config_.width; }
+    int Height() const { return config_.height; }
+    int Frames() const { return (int)frames_; }
+    int Held() const { return held_; }
+
+private:
+    V4L2Capture::Config config_;
+    bool loop_ = true;
+    const uint8_t* base_ = nullptr;
+    size_t mapped_ = 0;
+    size_t frameBytes_ = 0;
+    size_t frames_ = 0;
+    uint32_t next_ = 0; // sequence of the next frame
+    std::vector<bool> heldSlots_;
+    int held_ = 0;
+};
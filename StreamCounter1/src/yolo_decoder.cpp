@@ -0,0 +1,145 @@
+#include "yolo_decoder.hpp"
+
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cstring>
+
+void YoloV8Decoder::SetClassFilter(const std::vector<int>& classIds) {
+    classFilter_.clear();
+    for (int id : classIds) {
+        if (id >= 0 && std::find(classFilter_.begin(), classFilter_.end(), id) == classFilter_.end())
+            classFilter_.push_back(id);
+    }
+    std::sort(classFilter_.begin(), classFilter_.end());
+}
+
+int YoloV8Decoder::ScoredCount(int numClasses) const {
+    if (classFilter_.empty())
+        return numClasses;
+    // Sorted, so drop the ids past the head's class count
+    return (int)(std::lower_bound(classFilter_.begin(), classFilter_.end(), numClasses) -
+                 classFilter_.begin());
+}
+
+void YoloV8Decoder::Clear() {
+    boxes_.clear();
+    scores_.clear();
+    classIds_.clear();
+}
+
+int YoloV8Decoder::Decode(const cv::Mat& output, float confThreshold, const BoxTransform& transform) {
+    Clear();
+    if (output.empty() || output.type() != CV_32F || !output.isContinuous())
+        return 0;
+
+    // Drop the batch dimension: [1, X, Y] -> X x Y
+    int d0 = 0, d1 = 0;
+    if (output.dims == 3 && output.size[0] == 1) {
+        d0 = output.size[1];
+        d1 = output.size[2];
+    } else if (output.dims == 2) {
+        d0 = output.rows;
+        d1 = output.cols;
+    } else {
+        return 0;
+    }
+
+    return Decode(output.ptr<float>(), d0, d1, confThreshold, transform);
+}
+
+int YoloV8Decoder::Decode(const float* data, int d0, int d1, float confThreshold,
+                          const BoxTransform& transform) {
+    Clear();
+    if (!data || d0 <= 0 || d1 <= 0)
+        return 0;
+    // Heads always have far more anchors than attributes.
+    if (d0 <= d1)
+        return DecodeChannelMajor(data, d0, d1, confThreshold, transform);
+    return DecodeAnchorMajor(data, d0, d1, confThreshold, transform);
+}
+
+int YoloV8Decoder::DecodeChannelMajor(const float* data, int numAttrs, int numAnchors,
+                                      float confThreshold, const BoxTransform& transform) {
+    Clear();
+    const int numClasses = numAttrs - 4;
+    const int scored = ScoredCount(numClasses);
+    if (numClasses <= 0 || numAnchors <= 0 || scored <= 0)
+        return 0;
+
+    if ((int)bestScore_.size() < numAnchors) {
+        bestScore_.resize(numAnchors);
+        bestClass_.resize(numAnchors);
+    }
+    float* best = bestScore_.data();
+    float* bestCls = bestClass_.data();
+
+    // Column-wise argmax: seed with the first scored class, then fold in one
+    // class row at a time.
+    const int first = ScoredClass(0);
+    std::memcpy(best, data + (size_t)(4 + first) * numAnchors, numAnchors * sizeof(float));
+    std::fill(bestCls, bestCls + numAnchors, (float)first);
+
+    for (int i = 1; i < scored; ++i) {
+        const int c = ScoredClass(i);
+        const float* row = data + (size_t)(4 + c) * numAnchors;
+        int a = 0;
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+        const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 vc = cv::vx_setall_f32((float)c);
+        for (; a <= numAnchors - lanes; a += lanes) {
+            cv::v_float32 s = cv::vx_load(row + a);
+            cv::v_float32 m = cv::vx_load(best + a);
+            cv::v_float32 gt = cv::v_gt(s, m);
+            cv::v_store(best + a, cv::v_select(gt, s, m));
+            cv::v_store(bestCls + a, cv::v_select(gt, vc, cv::vx_load(bestCls + a)));
+        }
+#endif
+        for (; a < numAnchors; ++a) {
+            if (row[a] > best[a]) {
+                best[a] = row[a];
+                bestCls[a] = (float)c;
+            }
+        }
+    }
+
+    const float* cxRow = data;
+    const float* cyRow = data + numAnchors;
+    const float* wRow = data + 2 * (size_t)numAnchors;
+    const float* hRow = data + 3 * (size_t)numAnchors;
+    for (int a = 0; a < numAnchors; ++a) {
+        if (best[a] > confThreshold)
+            Emit(cxRow[a], cyRow[a], wRow[a], hRow[a], best[a], (int)bestCls[a], transform);
+    }
+    return (int)boxes_.size();
+}
+
+int YoloV8Decoder::DecodeAnchorMajor(const float* data, int numAnchors, int numAttrs,
+                                     float confThreshold, const BoxTransform& transform) {
+    const int numClasses = numAttrs - 4;
+    const int scored = ScoredCount(numClasses);
+    if (numClasses <= 0 || scored <= 0)
+        return 0;
+
+    for (int a = 0; a < numAnchors; ++a) {
+        const float* row = data + (size_t)a * numAttrs;
+        const float* scores = row + 4;
+        int bestId = ScoredClass(0);
+        for (int i = 1; i < scored; ++i) {
+            const int c = ScoredClass(i);
+            if (scores[c] > scores[bestId])
+                bestId = c;
+        }
+        if (scores[bestId] > confThreshold)
+            Emit(row[0], row[1], row[2], row[3], scores[bestId], bestId, transform);
+    }
+    return (int)boxes_.size();
+}
+
+void YoloV8Decoder::Emit(float cx, float cy, float w, float h, float score, int classId,
+                         const BoxTransform& transform) {
+    float left = (cx - 0.5f * w - transform.offsetX) * transform.scaleX + transform.originX;
+    float top = (cy - 0.5f * h - transform.offsetY) * transform.scaleY + transform.originY;
+    boxes_.emplace_back((int)left, (int)top, (int)(w * transform.scaleX), (int)(h * transform.scaleY));
+    scores_.push_back(score);
+    classIds_.push_back(classId);
+}
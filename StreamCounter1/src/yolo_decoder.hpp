@@ -0,0 +1,72 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+// Maps network-input coordinates back to frame coordinates:
+//   frameX = (netX - offsetX) * scaleX + originX
+// A plain stretch resize has zero offsets; letterboxing sets the padding.
+// origin is the top-left of the inference ROI when only a crop is forwarded.
+struct BoxTransform {
+    float scaleX = 1.f;
+    float scaleY = 1.f;
+    float offsetX = 0.f;
+    float offsetY = 0.f;
+    float originX = 0.f;
+    float originY = 0.f;
+};
+
+// Decoder for YOLOv8 detection heads. yolov8n.onnx emits [1, 4 + C, A]
+// (attributes x anchors, channel-major): the class scores of all anchors
+// are scanned row by row with SIMD, so each class costs one contiguous pass
+// and no per-anchor cv::Mat or minMaxLoc. Output vectors and scratch are
+// members and keep their capacity, so steady-state decoding does not
+// allocate. Not thread-safe; use one decoder per inference thread.
+//
+// With a class filter only the listed score rows are read: each candidate
+// takes its best score among those classes, so decode cost and the number
+// of boxes handed to NMS scale with the target classes instead of all 80.
+class YoloV8Decoder {
+public:
+    // Class ids to score; empty = all classes. Ids outside the head are
+    // ignored.
+    void SetClassFilter(const std::vector<int>& classIds);
+    const std::vector<int>& ClassFilter() const { return classFilter_; }
+
+    // Decodes one output blob. Accepts the channel-major [1, 4+C, A] layout
+    // and the transposed [1, A, 4+C] export. Returns the number of
+    // candidates with best class score > confThreshold.
+    int Decode(const cv::Mat& output, float confThreshold, const BoxTransform& transform);
+
+    // Same on a raw [1, d0, d1] head, e.g. an InferenceBackend output view;
+    // avoids building an N-d cv::Mat header (which allocates) per frame.
+    int Decode(const float* data, int d0, int d1, float confThreshold, const BoxTransform& transform);
+
+    // Raw channel-major entry point: data holds numAttrs rows of numAnchors.
+    int DecodeChannelMajor(const float* data, int numAttrs, int numAnchors,
+                           float confThreshold, const BoxTransform& transform);
+
+    void Clear();
+
+    const std::vector<cv::Rect>& Boxes() const { return boxes_; }
+    const std::vector<float>& Scores() const { return scores_; }
+    const std::vector<int>& ClassIds() const { return classIds_; }
+    size_t Size() const { return boxes_.size(); }
+
+private:
+    int DecodeAnchorMajor(const float* data, int numAnchors, int numAttrs,
+                          float confThreshold, const BoxTransform& transform);
+    void Emit(float cx, float cy, float w, float h, float score, int classId,
+              const BoxTransform& transform);
+
+    // Class id of the i-th scored row: the filter's entry, or i itself
+    int ScoredClass(int i) const { return classFilter_.empty() ? i : classFilter_[i]; }
+    int ScoredCount(int numClasses) const;
+
+    std::vector<int> classFilter_;
+    std::vector<float> bestScore_; // per-anchor scratch
+    std::vector<float> bestClass_; // class index kept as float for v_select
+    std::vector<cv::Rect> boxes_;
+    std::vector<float> scores_;
+    std::vector<int> classIds_;
+};
@@ -0,0 +1,317 @@
+#include "yolo_detector.hpp"
+#include "bench_stats.hpp"
+#include "int8_calibration.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+bool YoloDetector::Load(const DetectorConfig& config) {
+    loaded_ = false;
+    config_ = config;
+    precision_ = ModelPrecision::FP32;
+    classNames_.clear();
+
+    backend_ = CreateInferenceBackend(config.backend);
+    if (!backend_)
+        return false;
+    backend_->SetNumThreads(config.threads);
+    backend_->SetOptimizedCache(config.optimizedModelPath, config.reuseOptimizedModel);
+    std::cout << "[YOLO] Loading model (" << backend_->Name() << "): " << config.modelPath << "\n";
+    if (!backend_->Load(config.modelPath, config.inputSize))
+        return false;
+    if (backend_->LoadedOptimized())
+        std::cout << "[YOLO] Using optimised model: " << backend_->OptimizedCache() << "\n";
+
+    if (config.precision == ModelPrecision::INT8 && !LoadInt8())
+        std::cerr << "[YOLO] INT8 unavailable, running FP32\n";
+
+    std::ifstream ifs(config.classNamesPath);
+    if (!ifs.is_open()) {
+        std::cerr << "[YOLO] Cannot open class names: " << config.classNamesPath << "\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (!line.empty())
+            classNames_.push_back(line);
+    }
+
+    std::cout << "[YOLO] Loaded " << classNames_.size() << " class names\n";
+
+    if (!ResolveClassIds(config_.classes, classNames_, config_.classIds))
+        return false;
+    if (!config_.countClass.empty()) {
+        std::vector<int> countId;
+        if (!ResolveClassIds({ config_.countClass }, classNames_, countId))
+            return false;
+        config_.countClassId = countId[0];
+    }
+    decoder_.SetClassFilter(config_.classIds);
+    nms_.SetTopK(config_.nmsTopK);
+    if (!config_.classIds.empty()) {
+        std::cout << "[YOLO] Scoring " << config_.classIds.size() << " of " << classNames_.size()
+                  << " classes\n";
+        if (std::find(config_.classIds.begin(), config_.classIds.end(), config_.countClassId) ==
+            config_.classIds.end()) {
+            if (!config_.countClass.empty()) {
+                std::cerr << "[YOLO] Count class " << config_.countClass << " is not in the class list\n";
+                return false;
+            }
+            config_.countClassId = config_.classIds[0];
+        }
+    }
+    if (config_.countClassId >= 0 && config_.countClassId < (int)classNames_.size())
+        std::cout << "[YOLO] Counting " << classNames_[config_.countClassId] << "\n";
+    loaded_ = true;
+    return true;
+}
+
+bool YoloDetector::LoadInt8() {
+    if (!config_.int8ModelPath.empty() && std::ifstream(config_.int8ModelPath).good()) {
+        std::unique_ptr<InferenceBackend> backend = CreateInferenceBackend(config_.backend);
+        if (backend)
+            backend->SetNumThreads(config_.threads);
+        if (backend && backend->Load(config_.int8ModelPath, config_.inputSize)) {
+            backend_ = std::move(backend);
+            precision_ = ModelPrecision::INT8;
+            std::cout << "[YOLO] Loaded pre-quantised model: " << config_.int8ModelPath << "\n";
+            return true;
+        }
+    }
+
+    auto* opencv = dynamic_cast<OpenCvBackend*>(backend_.get());
+    if (!opencv) {
+        std::cerr << "[YOLO] Calibration needs the opencv backend; provide " << config_.int8ModelPath << "\n";
+        return false;
+    }
+
+    std::vector<cv::Mat> frames;
+    if (config_.calibrationDir.empty() || !LoadCalibrationFrames(config_.calibrationDir, frames)) {
+        std::cerr << "[YOLO] No calibration frames in " << config_.calibrationDir
+                  << " (run calibrate_int8)\n";
+        return false;
+    }
+
+    auto start = BenchClock::now();
+    cv::dnn::Net& net = opencv->Net();
+    if (!QuantizeNet(net, MakeCalibrationBlob(frames, config_.inputSize)))
+        return false;
+    net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    precision_ = ModelPrecision::INT8;
+    std::cout << "[YOLO] Quantised to INT8 with " << frames.size() << " calibration frames in "
+              << MsSince(start) << " ms\n";
+    return true;
+}
+
+int YoloDetector::CountObjects(const cv::Mat& frame, StageTimings* timings) {
+    return CountObjectsScaled(frame, 1, timings);
+}
+
+int YoloDetector::CountObjectsScaled(const cv::Mat& frame, int denom, StageTimings* timings) {
+    detections_.clear();
+    if (!loaded_ || frame.empty())
+        return 0;
+
+    StageTimings t;
+    try {
+        auto start = BenchClock::now();
+        const cv::Size input = config_.inputSize;
+        const cv::Rect& full = config_.roi;
+        const cv::Rect scaledRoi = full.empty() ? full
+            : cv::Rect(full.x / denom, full.y / denom, (full.width + denom - 1) / denom,
+                       (full.height + denom - 1) / denom);
+        const cv::Rect roi = AlignNv12Roi(scaledRoi, frame.cols, frame.rows);
+        const cv::Mat crop = frame(roi); // header only
+        const LetterboxGeometry g = ComputeLetterbox(crop.cols, crop.rows, input.width, input.height);
+        LetterboxBgrInto(crop, g, backend_->InputBuffer(1), resized_, converted_);
+        t.preprocessMs = MsSince(start);
+
+        BoxTransform transform = g.ToBoxTransform();
+        transform.scaleX *= denom;
+        transform.scaleY *= denom;
+        transform.originX = (float)(roi.x * denom);
+        transform.originY = (float)(roi.y * denom);
+        int count = RunForward(transform, t);
+        if (timings)
+            *timings = t;
+        return count;
+    } catch (const std::exception& e) {
+        std::cerr << "[YOLO] Inference error: " << e.what() << "\n";
+        return 0;
+    }
+}
+
+int YoloDetector::CountObjectsNV12(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane,
+                                   int uvStride, int width, int height, StageTimings* timings) {
+    detections_.clear();
+    if (!loaded_ || !yPlane || !uvPlane)
+        return 0;
+
+    StageTimings t;
+    try {
+        auto start = BenchClock::now();
+        const cv::Rect roi = AlignNv12Roi(config_.roi, width, height);
+        OffsetNv12Planes(roi, yPlane, yStride, uvPlane, uvStride);
+        nv12_.Configure(roi.width, roi.height, config_.inputSize.width, config_.inputSize.height);
+        nv12_.RunInto(yPlane, yStride, uvPlane, uvStride, backend_->InputBuffer(1));
+        t.preprocessMs = MsSince(start);
+
+        BoxTransform transform = nv12_.Transform();
+        transform.originX = (float)roi.x;
+        transform.originY = (float)roi.y;
+        int count = RunForward(transform, t);
+        if (timings)
+            *timings = t;
+        return count;
+    } catch (const std::exception& e) {
+        std::cerr << "[YOLO] Inference error: " << e.what() << "\n";
+        return 0;
+    }
+}
+
+int YoloDetector::CountStaged(const BoxTransform& transform, StageTimings* timings) {
+    detections_.clear();
+    if (!loaded_)
+        return 0;
+
+    StageTimings t;
+    try {
+        int count = RunForward(transform, t);
+        if (timings)
+            *timings = t;
+        return count;
+    } catch (const std::exception& e) {
+        std::cerr << "[YOLO] Inference error: " << e.what() << "\n";
+        return 0;
+    }
+}
+
+int YoloDetector::CountOutput(const BoxTransform& transform, StageTimings* timings) {
+    detections_.clear();
+    if (!loaded_)
+        return 0;
+
+    StageTimings t;
+    try {
+        int count = Postprocess(transform, t);
+        if (timings)
+            *timings = t;
+        return count;
+    } catch (const std::exception& e) {
+        std::cerr << "[YOLO] Inference error: " << e.what() << "\n";
+        return 0;
+    }
+}
+
+int YoloDetector::RunForward(const BoxTransform& transform, StageTimings& t) {
+    auto start = BenchClock::now();
+    backend_->Forward(1);
+    t.forwardMs = MsSince(start);
+    return Postprocess(transform, t);
+}
+
+int YoloDetector::Postprocess(const BoxTransform& transform, StageTimings& t) {
+    const TensorView output = backend_->Output(0);
+    if (!output.data || output.dims != 3 || output.shape[0] != 1)
+        return 0;
+
+    // YOLOv8 exports a single [1, 84, 8400] head
+    auto start = BenchClock::now();
+    const float threshold = config_.DecodeThreshold();
+    decoder_.Decode(output.data, output.shape[1], output.shape[2], threshold, transform);
+    t.decodeMs = MsSince(start);
+
+    start = BenchClock::now();
+    if (config_.agnosticNms)
+        nms_.Run(decoder_.Boxes(), decoder_.Scores(), threshold, config_.nmsThreshold, indices_);
+    else
+        nms_.Run(decoder_.Boxes(), decoder_.Scores(), decoder_.ClassIds(), threshold, config_.nmsThreshold,
+                 indices_);
+    t.nmsMs = MsSince(start);
+
+    const auto& classIds = decoder_.ClassIds();
+    int count = 0;
+    for (int idx : indices_) {
+        const float score = decoder_.Scores()[idx];
+        detections_.push_back({ classIds[idx], score, decoder_.Boxes()[idx] });
+        if (classIds[idx] == config_.countClassId && score > config_.confThreshold)
+            count++;
+    }
+    return count;
+}
+
+bool ParseInputSize(const std::string& text, cv::Size& size) {
+    int w = 0, h = 0;
+    const int fields = std::sscanf(text.c_str(), "%dx%d", &w, &h);
+    if (fields < 1 || w <= 0 || (fields == 2 && h <= 0))
+        return false;
+    if (fields == 1)
+        h = w;
+    auto roundUp = [](int v) { return (v + 31) / 32 * 32; };
+    size = cv::Size(roundUp(w), roundUp(h));
+    return true;
+}
+
+bool ParseClassList(const std::string& text, std::vector<std::string>& names) {
+    names.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos)
+            end = text.size();
+        if (end > start)
+            names.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return !names.empty();
+}
+
+bool ResolveClassIds(const std::vector<std::string>& names,
+                     const std::vector<std::string>& classNames, std::vector<int>& ids) {
+    ids.clear();
+    for (const std::string& name : names) {
+        auto it = std::find(classNames.begin(), classNames.end(), name);
+        if (it == classNames.end()) {
+            std::cerr << "[YOLO] Unknown class name: " << name << "\n";
+            return false;
+        }
+        ids.push_back((int)(it - classNames.begin()));
+    }
+    return true;
+}
+
+bool ParseRoi(const std::string& text, cv::Rect& roi) {
+    cv::Rect r;
+    if (std::sscanf(text.c_str(), "%d,%d,%d,%d", &r.x, &r.y, &r.width, &r.height) != 4 || r.empty())
+        return false;
+    roi = r;
+    return true;
+}
+
+bool LoadDetectorFromDefaultPaths(YoloDetector& detector, DetectorConfig config) {
+    static const char* kRoots[] = { "AIStuff/", "../AIStuff/", "../../AIStuff/" };
+
+    const bool customModel = !config.modelPath.empty();
+    const bool customNames = !config.classNamesPath.empty();
+    const bool customInt8 = !config.int8ModelPath.empty();
+    const bool customCalibration = !config.calibrationDir.empty();
+    if (customModel && customNames)
+        return detector.Load(config);
+
+    for (const char* root : kRoots) {
+        if (!customModel)
+            config.modelPath = std::string(root) + "yolov8n.onnx";
+        if (!customNames)
+            config.classNamesPath = std::string(root) + "coco.names";
+        if (!customInt8)
+            config.int8ModelPath = std::string(root) + "yolov8n_int8.onnx";
+        if (!customCalibration)
+            config.calibrationDir = std::string(root) + "calib";
+        if (detector.Load(config))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "inference_backend.hpp"
+#include "nms.hpp"
+#include "nv12_preprocess.hpp"
+#include "yolo_decoder.hpp"
+
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Portable version of the FishCounter YOLO pipeline:
+// preprocess -> forward -> decode -> NMS -> count.
+
+enum class ModelPrecision { FP32, INT8 };
+
+struct DetectorConfig {
+    std::string modelPath;
+    std::string classNamesPath;
+    // Network input W x H, multiples of 32. A non-square size such as
+    // 640x384 matches 16:9 frames with little padding, but the ONNX must be
+    // exported at that size or with dynamic axes.
+    cv::Size inputSize{ 640, 640 };
+
+    // Counting zone in frame pixels; only this crop is forwarded and boxes
+    // are mapped back to full-frame coordinates. Empty = whole frame.
+    cv::Rect roi;
+    float confThreshold = 0.5f;
+    float nmsThreshold = 0.45f;
+    int countClassId = 0; // class 0 = person
+    // Above 0 and below confThreshold: decode and NMS keep boxes down to
+    // this score for a tracker's low-score pass (ByteTracker lowScore).
+    // Counts still only take boxes above confThreshold; Detections() has all.
+    float trackThreshold = 0.f;
+
+    float DecodeThreshold() const {
+        return trackThreshold > 0.f && trackThreshold < confThreshold ? trackThreshold : confThreshold;
+    }
+
+    // NMS is per class (a car never suppresses a person) unless agnosticNms.
+    // nmsTopK caps the candidates NMS sorts and visits, best first; 0 = all.
+    bool agnosticNms = false;
+    int nmsTopK = 1000;
+
+    // Class whitelist by name, as in classNamesPath (e.g. "person"). Only
+    // these score channels are decoded and passed to NMS; empty = all.
+    // Load() resolves it into classIds, which InferenceBatcher reads.
+    std::vector<std::string> classes;
+    std::vector<int> classIds;
+    // Count class by name; Load() resolves it into countClassId. Empty keeps
+    // countClassId, or takes the first of classes if it is not among them.
+    std::string countClass;
+
+    // INT8 loads int8ModelPath if it exists (pre-quantised ONNX), otherwise
+    // quantises modelPath with the frames in calibrationDir. Falls back to
+    // FP32 if neither works; check YoloDetector::Precision().
+    ModelPrecision precision = ModelPrecision::FP32;
+    std::string int8ModelPath;
+    std::string calibrationDir;
+
+    // Runtime used for forward passes. INT8 calibration needs OpenCV; ONNX
+    // Runtime only runs pre-quantised INT8 models.
+    BackendKind backend = BackendKind::OpenCV;
+    int threads = 0; // intra-op threads per forward, 0 = runtime default
+
+    // Optimised model written by Load() (or read instead of modelPath with
+    // reuseOptimizedModel); see InferenceBackend::SetOptimizedCache. Only
+    // ONNX Runtime honours it. ModelManager sets both from its cache.
+    std::string optimizedModelPath;
+    bool reuseOptimizedModel = false;
+};
+
+struct Detection {
+    int classId = 0;
+    float confidence = 0.f;
+    cv::Rect box;
+};
+
+// Wall-clock time spent in each pipeline stage for one frame, in milliseconds.
+struct StageTimings {
+    double preprocessMs = 0.0;
+    double forwardMs = 0.0;
+    double decodeMs = 0.0;
+    double nmsMs = 0.0;
+};
+
+class YoloDetector {
+public:
+    bool Load(const DetectorConfig& config);
+    bool IsLoaded() const { return loaded_; }
+
+    // Runs the full pipeline on a BGR frame (letterboxed to the input size)
+    // and returns the number of detections of config.countClassId that
+    // survive NMS with a score above confThreshold.
+    int CountObjects(const cv::Mat& frame, StageTimings* timings = nullptr);
+
+    // Same, on a frame decoded at 1 / denom of the stream resolution (see
+    // MjpegDecoder); the ROI and the detections stay in stream pixels.
+    int CountObjectsScaled(const cv::Mat& frame, int denom, StageTimings* timings = nullptr);
+
+    // Same pipeline on raw NV12 planes (V4L2 / Media Foundation buffers),
+    // using the fused letterbox preprocessor instead of cvtColor + blobFromImage.
+    int CountObjectsNV12(const uint8_t* yPlane, int yStride, const uint8_t* uvPlane, int uvStride,
+                         int width, int height, StageTimings* timings = nullptr);
+
+    // Forward, decode and NMS on an input already written to
+    // Backend().InputBuffer(1), e.g. staged by InferencePool. transform maps
+    // network pixels back to the frame.
+    int CountStaged(const BoxTransform& transform, StageTimings* timings = nullptr);
+
+    // Decode and NMS only, on the backend's current output (no forward),
+    // e.g. to measure post-processing apart from the runtime.
+    int CountOutput(const BoxTransform& transform, StageTimings* timings = nullptr);
+
+    const std::vector<Detection>& Detections() const { return detections_; }
+    const std::vector<std::string>& ClassNames() const { return classNames_; }
+    const DetectorConfig& Config() const { return config_; }
+    ModelPrecision Precision() const { return precision_; }
+
+    // Loaded backend, e.g. for InferenceBatcher or warm-up. Valid after a
+    // successful Load().
+    InferenceBackend& Backend() { return *backend_; }
+
+private:
+    int RunForward(const BoxTransform& transform, StageTimings& t);
+    int Postprocess(const BoxTransform& transform, StageTimings& t);
+    bool LoadInt8();
+
+    DetectorConfig config_;
+    std::unique_ptr<InferenceBackend> backend_;
+    std::vector<std::string> classNames_;
+    Nv12Preprocessor nv12_;
+    cv::Mat resized_, converted_; // BGR letterbox path
+    YoloV8Decoder decoder_;
+    Nms nms_;
+    std::vector<int> indices_;
+    std::vector<Detection> detections_;
+    ModelPrecision precision_ = ModelPrecision::FP32;
+    bool loaded_ = false;
+};
+
+// Parses "N" (square) or "WxH"; rounds each side up to a multiple of 32.
+bool ParseInputSize(const std::string& text, cv::Size& size);
+
+// Parses a comma-separated class list, e.g. "person,car".
+bool ParseClassList(const std::string& text, std::vector<std::string>& names);
+
+// Maps class names to their line index in classNames. Fails (and logs) on
+// an unknown name.
+bool ResolveClassIds(const std::vector<std::string>& names,
+                     const std::vector<std::string>& classNames, std::vector<int>& ids);
+
+// Parses "x,y,w,h" in frame pixels.
+bool ParseRoi(const std::string& text, cv::Rect& roi);
+
+// Tries the usual model locations relative to the working directory
+// (AIStuff/, ../AIStuff/, ../../AIStuff/) in the same order as FishCounter.
+// Unset INT8 paths default to <root>/yolov8n_int8.onnx and <root>/calib.
+bool LoadDetectorFromDefaultPaths(YoloDetector& detector, DetectorConfig config);
@@ -0,0 +1,102 @@
+#include "zone_counter.hpp"
+#include "byte_tracker.hpp"
+#include "yolo_detector.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+bool ParseCountingZone(const std::string& text, CountingZone& zone) {
+    std::vector<int> values;
+    const char* p = text.c_str();
+    while (*p) {
+        char* end = nullptr;
+        const long v = std::strtol(p, &end, 10);
+        if (end == p)
+            return false;
+        values.push_back((int)v);
+        p = end;
+        if (*p == ',')
+            ++p;
+        else if (*p)
+            return false;
+    }
+    if (values.size() < 6 || values.size() % 2 != 0)
+        return false;
+    zone.polygon.clear();
+    for (size_t i = 0; i < values.size(); i += 2)
+        zone.polygon.emplace_back(values[i], values[i + 1]);
+    return true;
+}
+
+ZoneCounter::ZoneCounter(const std::vector<CountingZone>& zones, Anchor anchor)
+    : zones_(zones.begin(), zones.begin() + std::min((int)zones.size(), kMaxZones)), anchor_(anchor),
+      counts_(new std::atomic<int>[zones_.size()]) {
+    for (size_t i = 0; i < zones_.size(); ++i)
+        counts_[i].store(0, std::memory_order_relaxed);
+}
+
+void ZoneCounter::SetClassId(int classId) {
+    for (CountingZone& zone : zones_)
+        zone.classId = classId;
+}
+
+void ZoneCounter::Prepare(cv::Size frameSize) {
+    if (mask_.size() == frameSize || zones_.empty())
+        return;
+    mask_.create(frameSize, CV_8U);
+    mask_.setTo(0);
+    cv::Mat zoneMask(frameSize, CV_8U);
+    for (int z = 0; z < Zones(); ++z) {
+        zoneMask.setTo(0);
+        const std::vector<std::vector<cv::Point>> polygons{ zones_[z].polygon };
+        cv::fillPoly(zoneMask, polygons, cv::Scalar(1 << z));
+        cv::bitwise_or(mask_, zoneMask, mask_);
+    }
+}
+
+cv::Point ZoneCounter::AnchorOf(const cv::Rect& box) const {
+    const int x = box.x + box.width / 2;
+    if (anchor_ == Anchor::Center)
+        return cv::Point(x, box.y + box.height / 2);
+    return cv::Point(x, box.y + box.height - 1);
+}
+
+void ZoneCounter::Add(const cv::Rect& box, int classId, int* counts) const {
+    const cv::Point p = AnchorOf(box);
+    unsigned bits = ZonesAt(p.x, p.y);
+    for (int z = 0; bits; ++z, bits >>= 1) {
+        if ((bits & 1) && (zones_[z].classId < 0 || zones_[z].classId == classId))
+            ++counts[z];
+    }
+}
+
+void ZoneCounter::Publish(const int* counts) {
+    for (int z = 0; z < Zones(); ++z)
+        counts_[z].store(counts[z], std::memory_order_relaxed);
+}
+
+void ZoneCounter::Count(const std::vector<cv::Rect>& boxes, const std::vector<int>& classIds,
+                        const std::vector<int>& keep) {
+    int counts[kMaxZones] = {};
+    for (int idx : keep)
+        Add(boxes[idx], classIds[idx], counts);
+    Publish(counts);
+}
+
+void ZoneCounter::Count(const std::vector<Detection>& detections) {
+    int counts[kMaxZones] = {};
+    for (const Detection& d : detections)
+        Add(d.box, d.classId, counts);
+    Publish(counts);
+}
+
+void ZoneCounter::Count(const ByteTracker& tracker) {
+    int counts[kMaxZones] = {};
+    const int hold = tracker.GetConfig().occupancyHold;
+    for (int t = 0; t < tracker.Size(); ++t) {
+        if (tracker.Confirmed(t) && tracker.Lost(t) <= hold)
+            Add(tracker.Box(t), tracker.ClassId(t), counts);
+    }
+    Publish(counts);
+}
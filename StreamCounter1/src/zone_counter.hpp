@@ -0,0 +1,80 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ByteTracker;
+struct Detection;
+
+// Polygon counting zone (queue area, pen, ...) in frame pixels.
+struct CountingZone {
+    std::vector<cv::Point> polygon;
+    int classId = -1; // -1 = every class
+};
+
+// Parses "x1,y1,x2,y2,x3,y3[,...]" (at least three vertices) in frame pixels.
+bool ParseCountingZone(const std::string& text, CountingZone& zone);
+
+// Per-zone occupancy of a stream's detections.
+//
+// Prepare() rasterises the zones once per stream resolution into a label
+// image with one bit per zone (zones may overlap), so classifying a
+// detection is a single byte load at its anchor point instead of a
+// point-in-polygon test per zone. Count() takes the NMS output directly, or
+// the tracker's boxes, and replaces every zone's count.
+//
+// Counts are atomics: Count() runs on the inference thread while display or
+// reporting threads read Occupancy().
+class ZoneCounter {
+public:
+    static constexpr int kMaxZones = 8; // bits of the label image
+
+    // Point of the box that has to be inside the zone.
+    enum class Anchor {
+        BottomCenter, // feet / wheels; right for floor zones seen from above
+        Center,
+    };
+
+    ZoneCounter() = default;
+    // Zones beyond kMaxZones are ignored.
+    explicit ZoneCounter(const std::vector<CountingZone>& zones, Anchor anchor = Anchor::BottomCenter);
+
+    // Rebuilds the label image if frameSize changed; call before Count().
+    void Prepare(cv::Size frameSize);
+    // Counts only classId (-1 = every class) in every zone. Not thread-safe
+    // against Count().
+    void SetClassId(int classId);
+
+    // Post-NMS detections: boxes[i], classIds[i] for i in keep.
+    void Count(const std::vector<cv::Rect>& boxes, const std::vector<int>& classIds, const std::vector<int>& keep);
+    void Count(const std::vector<Detection>& detections);
+    // Confirmed tracks present (see ByteTracker::Occupancy), at their current,
+    // possibly predicted, boxes; for counts between inferences.
+    void Count(const ByteTracker& tracker);
+
+    // Zone bits at a frame pixel; 0 outside the frame or every zone.
+    uint8_t ZonesAt(int x, int y) const {
+        if ((unsigned)x >= (unsigned)mask_.cols || (unsigned)y >= (unsigned)mask_.rows)
+            return 0;
+        return mask_.ptr<uint8_t>(y)[x];
+    }
+
+    int Zones() const { return (int)zones_.size(); }
+    const CountingZone& Zone(int i) const { return zones_[i]; }
+    int Occupancy(int zone) const { return counts_[zone].load(std::memory_order_relaxed); }
+    const cv::Mat& Mask() const { return mask_; }
+
+private:
+    cv::Point AnchorOf(const cv::Rect& box) const;
+    void Add(const cv::Rect& box, int classId, int* counts) const;
+    void Publish(const int* counts);
+
+    std::vector<CountingZone> zones_;
+    Anchor anchor_ = Anchor::BottomCenter;
+    cv::Mat mask_; // CV_8U, bit z = inside zone z
+    std::unique_ptr<std::atomic<int>[]> counts_;
+};